@@ -7,5 +7,16 @@
 #include "Utils.hh"
 #include "OnionBuilding.hh"
 #include "CryptoContext.hh"
+#include "Signcryption.hh"
+#include "BatchVerification.hh"
+#include "Signatures.hh"
+#include "MerkleSignature.hh"
+#include "KeyCache.hh"
+#include "KeySet.hh"
+#include "KeyPairPool.hh"
+#include "KeyHandle.hh"
+#include "KeyDirectory.hh"
+#include "KeyAddress.hh"
+#include "MasterKey.hh"
 
 #endif
@@ -1,12 +1,15 @@
 #ifndef ASYMMETRIC_CIPHER_HH
 #define ASYMMETRIC_CIPHER_HH
 
+#include "AsymmetricKey.hh"
 #include "EvpCipherContext.hh"
 
 class AsymmetricEvpCipherContext : public EvpCipherContext
 {
     unsigned char *encryptedKey;
     int encryptedKeyLength;
+    // reference to the key taken for the current operation, so a key handle may rotate it meanwhile;
+    EVP_PKEY *operationKey;
 
     AsymmetricEvpCipherContext(const AsymmetricEvpCipherContext &);
     const AsymmetricEvpCipherContext *operator=(const AsymmetricEvpCipherContext &);
@@ -22,6 +25,20 @@ class AsymmetricEvpCipherContext : public EvpCipherContext
         }
     }
 
+    EVP_PKEY *acquireOperationKey()
+    {
+        EVP_PKEY_free(this->operationKey);
+        this->operationKey = static_cast<const AsymmetricKey *>(this->getKey())->acquire();
+
+        return this->operationKey;
+    }
+
+    void freeOperationKey()
+    {
+        EVP_PKEY_free(this->operationKey);
+        this->operationKey = nullptr;
+    }
+
     bool allocateEncryptedKey()
     {
         int pkeySize = this->getKeySize();
@@ -100,18 +117,36 @@ public:
     {
         this->encryptedKey = nullptr;
         this->encryptedKeyLength = 0;
+        this->operationKey = nullptr;
     }
 
-    ~AsymmetricEvpCipherContext() { this->freeEncryptedKey(); }
+    ~AsymmetricEvpCipherContext()
+    {
+        this->freeEncryptedKey();
+        this->freeOperationKey();
+    }
 
     EncrypterResult *encrypt(const EncrypterData *in) override;
 
     EncrypterResult *decrypt(const EncrypterData *in) override;
 
+    /**
+     * @brief Create an envelope in place: the plaintext, already at its position within the
+     * envelope, is encrypted where it is, and the encrypted key, IV and tag are written around it.
+     * See createEnvelope for the layout.
+     *
+     * @param envelope buffer of N + IV_SIZE + plaintextLen + TAG_SIZE bytes holding the plaintext
+     * at offset N + IV_SIZE
+     * @param plaintextLen size of the plaintext
+     * @return true on success
+     */
+    bool sealInPlace(unsigned char *envelope, unsigned int plaintextLen);
+
     void cleanup() override
     {
         EvpCipherContext::cleanup();
         this->freeEncryptedKey();
+        this->freeOperationKey();
     }
 
     class Factory
@@ -2,13 +2,34 @@
 #define ASYMMETRIC_KEY_HH
 
 #include "Key.hh"
+#include "Constants.hh"
+#include "enums/KeyFormat.hh"
+#include "enums/KeyPairType.hh"
 #include "exceptions/InvalidKey.hh"
 
+#include <atomic>
+#include <mutex>
 #include <openssl/pem.h>
 
+class KeyHandle;
+
 class AsymmetricKey : public Key
 {
-    EVP_PKEY *key;
+    // a key bound to a handle follows its rotations lazily, whenever the key is accessed, and
+    // releases the key it held; operations therefore run on a reference taken with acquire().
+    // Threads sharing the key only lock handleMutex to follow a rotation;
+    mutable std::atomic<EVP_PKEY *> key;
+    const KeyHandle *handle;
+    mutable std::atomic<unsigned long> handleVersion;
+    mutable std::mutex handleMutex;
+
+    // the address is derived once per key; addressKey holds a reference to the key it was derived
+    // from, so its pointer cannot be reused by another key while the address is cached;
+    mutable std::mutex addressMutex;
+    mutable EVP_PKEY *addressKey;
+    mutable unsigned char address[ADDRESS_SIZE];
+
+    void followHandle() const;
 
     AsymmetricKey(const AsymmetricKey &);
 
@@ -18,6 +39,9 @@ class AsymmetricKey : public Key
     {
         this->setKeyType(keyType);
         this->key = nullptr;
+        this->handle = nullptr;
+        this->handleVersion = 0;
+        this->addressKey = nullptr;
     }
 
 public:
@@ -27,14 +51,119 @@ public:
 
     bool readKeyFile(const char *path, const char *passphrase = nullptr) override;
 
-    int getSize() const override { return this->notNullKeyData() ? EVP_PKEY_size(this->key) : -1; }
+    /**
+     * @brief Initialize the key from a buffer in the given format. DER keys are SubjectPublicKeyInfo
+     * for public keys and PKCS#8 (optionally encrypted) or traditional structures for private keys;
+     * raw keys are the 32 bytes of an X25519 or Ed25519 key and take no passphrase.
+     *
+     * @param keyData key material
+     * @param len size of keyData
+     * @param format format of keyData
+     * @param passphrase [Optional] passphrase to unlock a PEM or DER private key
+     * @return true if initialization successful
+     */
+    bool setKeyData(const unsigned char *keyData, unsigned int len, KeyFormat format, const char *passphrase = nullptr);
+
+    /**
+     * @brief Read the key from a file in the given format.
+     *
+     * @param path path to the key file
+     * @param format format of the file content
+     * @param passphrase [Optional] passphrase to unlock a PEM or DER private key
+     * @return true if initialization successful
+     */
+    bool readKeyFile(const char *path, KeyFormat format, const char *passphrase = nullptr);
+
+    /**
+     * @brief Replace the key with a newly generated private key.
+     *
+     * @param type algorithm of the key
+     * @param bits modulus size for RSA keys; ignored otherwise
+     * @return true if the object is a private key and generation succeeded
+     */
+    bool generate(KeyPairType type, unsigned int bits);
+
+    /**
+     * @brief Encode the key. Private keys are written as PKCS#8, encrypted with AES-256-CBC when a
+     * passphrase is given; raw formats are only available for keys of the matching algorithm.
+     *
+     * @param format output format
+     * @param len size of the encoded key
+     * @param passphrase [Optional] passphrase protecting a PEM or DER private key
+     * @return unsigned char* encoded key owned by the caller (delete[]) or nullptr on failure
+     */
+    unsigned char *exportKey(KeyFormat format, unsigned int &len, const char *passphrase = nullptr) const;
+
+    /**
+     * @brief Encode the public half of the key, for public and private keys alike.
+     *
+     * @param format output format
+     * @param len size of the encoded key
+     * @return unsigned char* encoded key owned by the caller (delete[]) or nullptr on failure
+     */
+    unsigned char *exportPublicKey(KeyFormat format, unsigned int &len) const;
+
+    /**
+     * @brief Use the key already parsed by another key object of the same type; both objects hold
+     * their own reference to it. If other is bound to a handle, this key is bound to it as well
+     * and follows its rotations.
+     *
+     * @param other key to be shared
+     * @return true if the key is shared
+     */
+    bool shareKey(const AsymmetricKey *other);
+
+    /**
+     * @brief Get the address of the key: the SHA-256 of its public half encoded as DER
+     * (SubjectPublicKeyInfo), so that a private key and its public key share an address. The
+     * address is computed on first use and cached until the key changes.
+     *
+     * @param address output buffer of ADDRESS_SIZE bytes
+     * @return true on success
+     */
+    bool getAddress(unsigned char *address) const;
+
+    int getSize() const override;
 
-    const void *getKeyData() const override { return this->key; }
+    /**
+     * @brief Bind the key to a handle: the key becomes the current key of the handle and follows
+     * its rotations from then on. The handle must outlive the key object.
+     *
+     * @param handle handle of a key of the same type
+     * @return true if the key is bound
+     */
+    bool bindHandle(const KeyHandle *handle);
+
+    /**
+     * @brief Take a reference to the current key; for a key bound to a handle, the current key of
+     * the handle. The key stays valid until the reference is released, whatever rotations happen.
+     *
+     * @return EVP_PKEY* new reference the caller releases with EVP_PKEY_free or nullptr if not set
+     */
+    EVP_PKEY *acquire() const;
+
+    /**
+     * @brief Get the key without taking a reference. For a key bound to a handle, the key is only
+     * valid until the next rotation is followed, by this or another thread; use acquire instead
+     * to keep it for an operation.
+     */
+    const void *getKeyData() const override
+    {
+        if (this->handle)
+        {
+            this->followHandle();
+        }
+
+        return this->key;
+    }
 
     void freeKey() override
     {
         EVP_PKEY_free(this->key);
+        EVP_PKEY_free(this->addressKey);
         this->key = nullptr;
+        this->handle = nullptr;
+        this->addressKey = nullptr;
     }
 
     class Factory
@@ -102,6 +231,90 @@ public:
             return key;
         }
 
+        /**
+         * @brief Create a Public Key object using a public key in any supported format.
+         *
+         * @param keyData key material
+         * @param keylen size of keyData
+         * @param format format of keyData
+         * @return AsymmetricKey* pointer to newly created object
+         */
+        static AsymmetricKey *createPublicKeyFromData(const unsigned char *keyData, unsigned int keylen, KeyFormat format)
+        {
+            AsymmetricKey *key = createPublicKey();
+
+            if (!key->setKeyData(keyData, keylen, format))
+            {
+                delete key;
+                return nullptr;
+            }
+
+            return key;
+        }
+
+        /**
+         * @brief Create a Private Key object using a private key in any supported format.
+         *
+         * @param keyData key material
+         * @param keylen size of keyData
+         * @param format format of keyData
+         * @param passphrase [Optional] passphrase to unlock the key
+         * @return AsymmetricKey* pointer to newly created object
+         */
+        static AsymmetricKey *createPrivateKeyFromData(const unsigned char *keyData, unsigned int keylen, KeyFormat format, char *passphrase = nullptr)
+        {
+            AsymmetricKey *key = createPrivateKey();
+
+            if (!key->setKeyData(keyData, keylen, format, passphrase))
+            {
+                delete key;
+                return nullptr;
+            }
+
+            return key;
+        }
+
+        /**
+         * @brief Generate a new private key in process.
+         *
+         * @param type algorithm of the key
+         * @param bits [Optional] modulus size for RSA keys
+         * @return AsymmetricKey* pointer to newly created object
+         */
+        static AsymmetricKey *generatePrivateKey(KeyPairType type, unsigned int bits = 2048)
+        {
+            AsymmetricKey *key = createPrivateKey();
+
+            if (!key->generate(type, bits))
+            {
+                delete key;
+                return nullptr;
+            }
+
+            return key;
+        }
+
+        /**
+         * @brief Create a Public Key object holding only the public half of a private key.
+         *
+         * @param privateKey private key
+         * @return AsymmetricKey* pointer to newly created object
+         */
+        static AsymmetricKey *createPublicKeyFromPrivateKey(const AsymmetricKey *privateKey)
+        {
+            unsigned int len;
+            unsigned char *der = privateKey and privateKey->isPrivateKey() ? privateKey->exportPublicKey(DerKeyFormat, len) : nullptr;
+            AsymmetricKey *key = nullptr;
+
+            if (der)
+            {
+                key = createPublicKeyFromData(der, len, DerKeyFormat);
+                delete[] der;
+            }
+
+            return key;
+        }
+
         /**
          * @brief Create a Public Key object using a public key file in PEM format.
          *
@@ -0,0 +1,25 @@
+#ifndef BATCH_VERIFICATION_HH
+#define BATCH_VERIFICATION_HH
+
+#include "CryptoContext.hh"
+
+extern "C"
+{
+    unsigned int GetVerificationBitmapSize(unsigned int count);
+
+    bool IsVerified(const unsigned char *bitmap, unsigned int index);
+
+    /**
+     * @brief Verify many signed buffers (data followed by signature) on the process-wide worker pool.
+     *
+     * ctxCount is either 1, in which case every buffer is verified with ctx[0], or equal to count,
+     * in which case signedData[i] is verified with ctx[i]. Bit (i % 8) of bitmap[i / 8] is set if and
+     * only if signedData[i] holds a valid signature; bitmap must be GetVerificationBitmapSize(count) bytes.
+     * Every worker thread reuses its own digest context across items.
+     *
+     * @return true if all signatures are valid
+     */
+    bool VerifySignaturesParallel(CryptoContext **ctx, unsigned int ctxCount, const unsigned char **signedData, const unsigned int *signedDataLen, unsigned int count, unsigned char *bitmap);
+}
+
+#endif
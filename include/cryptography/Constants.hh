@@ -5,7 +5,12 @@
 #define IV_SIZE 12
 #define TAG_SIZE 16
 #define ONION_LENGTH_BYTES 2
+#define ONION_V2_VERSION 2
+#define ONION_V2_LENGTH_BYTES 4
 #define ADDRESS_SIZE 32
 #define PKEY_SIZE 2048
+#define ED25519_SIGNATURE_SIZE 64
+#define STREAM_CHUNK_SIZE 16384
+#define SIGNATURE_DIGEST_SIZE 32
 
 #endif
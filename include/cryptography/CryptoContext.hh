@@ -7,12 +7,17 @@
 #include "AsymmetricKey.hh"
 #include "enums/CryptoOp.hh"
 #include "enums/CryptoType.hh"
+#include "enums/DigestType.hh"
 #include "exceptions/InvalidOperation.hh"
 
+class EvpMdContext;
+class VerificationCache;
+
 class CryptoContext
 {
     CryptoType cryptoType;
     CryptoOp cryptoOp;
+    DigestType digestType;
 
     Key *key;
     EvpContext *cipher;
@@ -74,6 +79,7 @@ class CryptoContext
         this->cryptoMachine = nullptr;
         this->key = nullptr;
         this->cipher = nullptr;
+        this->digestType = Sha256Digest;
         this->setCryptoType(cryptoType);
         this->setCryptoOp(cryptoOp);
         this->allocateMemory();
@@ -84,6 +90,7 @@ class CryptoContext
         this->cryptoMachine = nullptr;
         this->key = nullptr;
         this->cipher = nullptr;
+        this->digestType = Sha256Digest;
     }
 
 public:
@@ -97,6 +104,30 @@ public:
 
     void setCryptoOp(CryptoOp cryptoOp) { this->cryptoOp = cryptoOp; }
 
+    DigestType getDigestType() const { return this->digestType; }
+
+    /**
+     * @brief Set the digest used by RSA signature contexts; it has no effect on Ed25519 contexts.
+     * One-shot verification (VerifySignature, VerifyDetachedSignature) retries a failed RSA signature
+     * once with the digest it encloses, leaving this digest unchanged; incremental, digest and batch
+     * verification only use this digest.
+     *
+     * @param digestType digest to be used
+     */
+    void setDigestType(DigestType digestType);
+
+    const Key *getKey() const { return this->key; }
+
+    /**
+     * @brief Encrypt into an envelope in place, without copying the plaintext; only available to
+     * asymmetric encryption contexts. See AsymmetricEvpCipherContext::sealInPlace.
+     *
+     * @return true on success
+     */
+    bool sealEnvelopeInPlace(unsigned char *envelope, unsigned int plaintextLen);
+
+    int getKeySize() const { return this->notNullKey() ? this->key->getSize() : -1; }
+
     bool allocateMemory()
     {
         return this->initKey() and
@@ -114,6 +145,16 @@ public:
         return this->notNullKey() and this->key->setKeyData(key, SYMMETRIC_KEY_SIZE);
     }
 
+    bool deriveKey256(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen)
+    {
+        if (this->notNullKey() and !this->key->isSymmetricKey())
+        {
+            throw InvalidKey(INVALID_KEY_MATERIAL);
+        }
+
+        return this->notNullKey() and static_cast<SymmetricKey *>(this->key)->deriveKeyData(masterKey, purpose, peer, peerLen);
+    }
+
     bool setKeyData(const char *key, const char *passphrase = nullptr)
     {
         return this->notNullKey() and this->key->setKeyData((const unsigned char *)key, strlen(key), passphrase);
@@ -129,6 +170,46 @@ public:
         return this->notNullKey() and this->key->readKeyFile(path, passphrase);
     }
 
+    bool setKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase = nullptr)
+    {
+        if (this->notNullKey() and this->key->isSymmetricKey())
+        {
+            throw InvalidKey(INVALID_KEY_MATERIAL);
+        }
+
+        return this->notNullKey() and static_cast<AsymmetricKey *>(this->key)->setKeyData(key, keylen, format, passphrase);
+    }
+
+    bool shareKey(const AsymmetricKey *key)
+    {
+        if (this->notNullKey() and this->key->isSymmetricKey())
+        {
+            throw InvalidKey(INVALID_KEY_MATERIAL);
+        }
+
+        return this->notNullKey() and static_cast<AsymmetricKey *>(this->key)->shareKey(key);
+    }
+
+    bool bindKeyHandle(const KeyHandle *handle)
+    {
+        if (this->notNullKey() and this->key->isSymmetricKey())
+        {
+            throw InvalidKey(INVALID_KEY_MATERIAL);
+        }
+
+        return this->notNullKey() and static_cast<AsymmetricKey *>(this->key)->bindHandle(handle);
+    }
+
+    bool readKeyFile(const char *path, KeyFormat format, const char *passphrase = nullptr)
+    {
+        if (this->notNullKey() and this->key->isSymmetricKey())
+        {
+            throw InvalidKey(INVALID_KEY_MATERIAL);
+        }
+
+        return this->notNullKey() and static_cast<AsymmetricKey *>(this->key)->readKeyFile(path, format, passphrase);
+    }
+
     bool isSetForEncryption() const
     {
         return this->notNullCryptoMachine() and this->getCryptoOp() == Encrypt;
@@ -181,6 +262,23 @@ public:
 
     bool run() { return this->notNullCryptoMachine() and this->cryptoMachine->run(); }
 
+    bool verifyBatch(const unsigned char **data, const unsigned int *datalen, unsigned int count, bool *results);
+
+    /**
+     * @brief Get the signature cipher of a context set for signing or verifying.
+     *
+     * @return EvpMdContext* the cipher or nullptr for any other kind of context
+     */
+    EvpMdContext *getSignatureCipher() const;
+
+    /**
+     * @brief Attach a cache of successful verifications to a context set for verifying.
+     *
+     * @param cache cache to be used, or nullptr to disable caching
+     * @return true if the context is set for verifying
+     */
+    bool setVerificationCache(VerificationCache *cache);
+
     void cleanup()
     {
         this->freeCryptoMachine();
@@ -221,6 +319,16 @@ public:
             return new CryptoContext(AsymmetricCryptography, SignVerify);
         }
 
+        static CryptoContext *createEd25519SignatureContext()
+        {
+            return new CryptoContext(Ed25519Cryptography, Sign);
+        }
+
+        static CryptoContext *createEd25519SignatureVerificationContext()
+        {
+            return new CryptoContext(Ed25519Cryptography, SignVerify);
+        }
+
         static CryptoContext *CreateCryptoContext()
         {
             return new CryptoContext();
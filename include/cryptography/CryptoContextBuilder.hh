@@ -63,6 +63,16 @@ private:
             return this;
         }
 
+        ICryptoContextBuilder *deriveKey256(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen) override
+        {
+            if (!this->ctx->deriveKey256(masterKey, purpose, peer, peerLen))
+            {
+                throw InvalidOperation(COULD_NOT_SET_KEY);
+            }
+
+            return this;
+        }
+
         ICryptoContextBuilder *setKey(const char *key) override
         {
             if (!this->ctx->setKeyData(key))
@@ -103,6 +113,56 @@ private:
             return this;
         }
 
+        ICryptoContextBuilder *setKey(const unsigned char *key, unsigned int keylen, KeyFormat format) override
+        {
+            return this->setKey(key, keylen, format, nullptr);
+        }
+
+        ICryptoContextBuilder *setKey(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase) override
+        {
+            if (!this->ctx->setKeyData(key, keylen, format, passphrase))
+            {
+                throw InvalidOperation(COULD_NOT_SET_KEY);
+            }
+
+            return this;
+        }
+
+        ICryptoContextBuilder *readKeyData(const char *path, KeyFormat format) override
+        {
+            return this->readKeyData(path, format, nullptr);
+        }
+
+        ICryptoContextBuilder *readKeyData(const char *path, KeyFormat format, const char *passphrase) override
+        {
+            if (!this->ctx->readKeyFile(path, format, passphrase))
+            {
+                throw InvalidOperation(COULD_NOT_SET_KEY);
+            }
+
+            return this;
+        }
+
+        ICryptoContextBuilder *shareKey(const AsymmetricKey *key) override
+        {
+            if (!this->ctx->shareKey(key))
+            {
+                throw InvalidOperation(COULD_NOT_SET_KEY);
+            }
+
+            return this;
+        }
+
+        ICryptoContextBuilder *bindKeyHandle(const KeyHandle *handle) override
+        {
+            if (!this->ctx->bindKeyHandle(handle))
+            {
+                throw InvalidOperation(COULD_NOT_SET_KEY);
+            }
+
+            return this;
+        }
+
         ICryptoContextBuilderKeyData *setPlaintext(const unsigned char *data, unsigned int datalen) override
         {
             if (!this->ctx->setPlaintext(data, datalen))
@@ -135,6 +195,18 @@ private:
             return this;
         }
 
+        ICryptoContextBuilderSignatureOperation *useDigest(DigestType digestType) override
+        {
+            this->ctx->setDigestType(digestType);
+            return this;
+        }
+
+        ICryptoContextBuilderSignatureOperation *useEd25519() override
+        {
+            this->ctx->setCryptoType(Ed25519Cryptography);
+            return this;
+        }
+
         ICryptoContextBuilderPlaintext *useEncryption() override
         {
             this->ctx->setCryptoOp(Encrypt);
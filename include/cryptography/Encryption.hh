@@ -19,6 +19,8 @@ extern "C"
     const EncrypterResult *SignDataEx(CryptoContext *ctx, const unsigned char *plaintext, unsigned int plaintextLen);
 
     bool VerifySignature(CryptoContext *ctx, const unsigned char *ciphertext, unsigned int cipherLen);
+
+    bool VerifySignatures(CryptoContext *ctx, const unsigned char **ciphertexts, const unsigned int *cipherLens, unsigned int count, bool *results);
 }
 
 #endif
@@ -1,46 +1,39 @@
 #ifndef EVP_MD_CONTEXT_HH
 #define EVP_MD_CONTEXT_HH
 
+#include "AsymmetricKey.hh"
 #include "EvpContext.hh"
+#include "VerificationCache.hh"
+#include "enums/DigestType.hh"
 
 class EvpMdContext : public EvpContext
 {
     EVP_MD_CTX *mdContext;
 
-    unsigned char *inSig;
-    unsigned int inSiglen;
+    // contexts initialized once for templateKey; every operation starts from a copy of one of them;
+    EVP_MD_CTX *signTemplate;
+    EVP_MD_CTX *verifyTemplate;
+    EVP_PKEY *templateKey;
 
-    bool notNullInSig() const { return this->inSig != nullptr; }
+    // public-key contexts signing and verifying precomputed digests, also bound to templateKey;
+    EVP_PKEY_CTX *digestSignContext;
+    EVP_PKEY_CTX *digestVerifyContext;
 
-    void freeInSig()
-    {
-        if (this->inSig)
-        {
-            memset(this->inSig, 0, this->inSiglen);
-            delete[] this->inSig;
-            this->inSig = nullptr;
-        }
-    }
+    // SHA-256 of the DER encoded public part of templateKey, identifying it in verificationCache;
+    unsigned char keyIdentity[VERIFICATION_CACHE_DIGEST_SIZE];
 
-    bool allocateInSig(unsigned int len)
-    {
-        this->freeInSig();
-        this->inSig = new unsigned char[len + 1];
+    // optional, not owned;
+    VerificationCache *verificationCache;
+    EVP_MD_CTX *hashContext;
 
-        return this->notNullInSig();
-    }
+    // output buffer is kept across operations, as the signature size only changes with the key;
+    unsigned int outBufferCapacity;
 
-    bool writeInSig(const unsigned char *inSig, unsigned int len)
-    {
-        if (inSig and this->inSig)
-        {
-            memcpy(this->inSig, inSig, len);
-            this->inSiglen = len;
-            return true;
-        }
+    // EVP_PKEY_ED25519 when the context was created for Ed25519, EVP_PKEY_NONE for RSA;
+    int pkeyId;
 
-        return false;
-    }
+    // digest of RSA signatures; templates are built for it;
+    const EVP_MD *digest;
 
     void freeMdContext()
     {
@@ -56,6 +49,130 @@ class EvpMdContext : public EvpContext
         return this->mdContext != nullptr;
     }
 
+    bool initMdContext()
+    {
+        return this->notNullMdContext() or this->allocateMdContext();
+    }
+
+    void freeHashContext()
+    {
+        EVP_MD_CTX_free(this->hashContext);
+        this->hashContext = nullptr;
+    }
+
+    void freeTemplates()
+    {
+        EVP_MD_CTX_free(this->signTemplate);
+        EVP_MD_CTX_free(this->verifyTemplate);
+        EVP_PKEY_CTX_free(this->digestSignContext);
+        EVP_PKEY_CTX_free(this->digestVerifyContext);
+        EVP_PKEY_free(this->templateKey);
+
+        this->signTemplate = nullptr;
+        this->verifyTemplate = nullptr;
+        this->digestSignContext = nullptr;
+        this->digestVerifyContext = nullptr;
+        this->templateKey = nullptr;
+    }
+
+    /**
+     * @brief Make pkey the key templates and key identity are built for, dropping those of a previous key.
+     * A reference to pkey is held, so a key replaced in the meantime is always detected.
+     *
+     * @param pkey key loaded into this context
+     * @return true on success
+     */
+    bool bindKey(EVP_PKEY *pkey);
+
+    /**
+     * @brief Hash key identity, data and signature into the digest used as verificationCache entry.
+     *
+     * @return true on success
+     */
+    bool createCacheDigest(const unsigned char *in, unsigned int inlen, const unsigned char *sig, unsigned int siglen, unsigned char *digest);
+
+    /**
+     * @brief Get the signing or verification template for pkey, initializing it on first use.
+     *
+     * @param signing true for the signing template, false for the verification one
+     * @param pkey key loaded into this context
+     * @return EVP_MD_CTX* template or nullptr on error
+     */
+    EVP_MD_CTX *getTemplate(bool signing, EVP_PKEY *pkey);
+
+    /**
+     * @brief Get the public-key context signing or verifying digests with the key loaded into this context,
+     * initializing it on first use. It is reused as is, since EVP_PKEY_sign and EVP_PKEY_verify keep no state.
+     *
+     * @param signing true for signing, false for verification
+     * @return EVP_PKEY_CTX* context or nullptr if the key cannot sign digests (i.e. Ed25519)
+     */
+    EVP_PKEY_CTX *getDigestContext(bool signing);
+
+    bool isSuitableDigest(unsigned int digestlen) const
+    {
+        return not this->isEd25519() and digestlen == (unsigned int)EVP_MD_get_size(this->getDigest());
+    }
+
+    /**
+     * @brief Prepare mdContext for a new operation by copying the matching template into it,
+     * instead of running EVP_DigestSignInit/EVP_DigestVerifyInit again.
+     *
+     * @param signing true for signing, false for verification
+     * @return true on success
+     */
+    bool startOperation(bool signing);
+
+    /**
+     * @brief Find the digest an RSA signature was created with, from the DigestInfo it encloses.
+     *
+     * @param pkey key the signature is verified with
+     * @param sig signature
+     * @param siglen size of signature
+     * @return const EVP_MD* supported digest other than the one of this context or nullptr
+     */
+    const EVP_MD *detectDigest(EVP_PKEY *pkey, const unsigned char *sig, unsigned int siglen) const;
+
+    bool reserveOutBuffer(unsigned int len)
+    {
+        if (this->getOutBuffer() and this->outBufferCapacity >= len)
+        {
+            return true;
+        }
+
+        this->freeOutBuffer();
+        this->outBufferCapacity = this->allocateOutBuffer(len) ? len : 0;
+
+        return this->outBufferCapacity == len;
+    }
+
+    bool isEd25519() const { return this->pkeyId == EVP_PKEY_ED25519; }
+
+    /**
+     * @brief Check the key loaded into this context matches the signature algorithm the context
+     * was created for (i.e. an Ed25519 context will refuse RSA keys and vice versa).
+     */
+    bool isSuitableKey(EVP_PKEY *pkey) const
+    {
+        if (not pkey)
+        {
+            return false;
+        }
+
+        int id = EVP_PKEY_get_base_id(pkey);
+
+        return this->isEd25519() ? id == EVP_PKEY_ED25519 : id != EVP_PKEY_ED25519 and id != EVP_PKEY_ED448;
+    }
+
+    /**
+     * @brief Sign data and store the signature alone in the output buffer of this context.
+     *
+     * @param in data to be signed
+     * @param inlen size of data
+     * @return true on success
+     */
+    bool createSignature(const unsigned char *in, unsigned int inlen);
+
     /**
      * @brief Create a signature
      *
@@ -68,41 +185,248 @@ class EvpMdContext : public EvpContext
      */
     EncrypterResult *createSignedData(const EncrypterData *in) const;
 
-    /**
-     * @brief Read a byte array resulted from createSignedData and initializes internal structures
-     *
-     * @param in structure containing data do be verified and its size
-     * @param datasize if successful it contains the data size
-     * @return const unsigned char * pointer to data
-     */
-    const unsigned char *readSignedData(const EncrypterData *in, int &datasize);
-
     bool notNullMdContext() const { return this->mdContext != nullptr; }
 
 public:
-    EvpMdContext(Key *key) : EvpContext(key)
+    EvpMdContext(Key *key, int pkeyId = EVP_PKEY_NONE, DigestType digestType = Sha256Digest) : EvpContext(key)
     {
+        this->pkeyId = pkeyId;
+        this->digest = getDigestByType(digestType);
         this->mdContext = nullptr;
-        this->inSig = nullptr;
-        this->inSiglen = 0;
+        this->signTemplate = nullptr;
+        this->verifyTemplate = nullptr;
+        this->templateKey = nullptr;
+        this->digestSignContext = nullptr;
+        this->digestVerifyContext = nullptr;
+        this->verificationCache = nullptr;
+        this->hashContext = nullptr;
+        this->outBufferCapacity = 0;
     }
 
     ~EvpMdContext()
     {
-        this->freeInSig();
         this->freeMdContext();
+        this->freeHashContext();
+        this->freeTemplates();
+    }
+
+    /**
+     * @brief Let successful verifications be remembered in cache, so the same signed bytes verified
+     * again with the same key are accepted after a single hash pass. The cache must outlive this context.
+     *
+     * @param cache cache to be used; nullptr disables caching
+     */
+    void setVerificationCache(VerificationCache *cache) { this->verificationCache = cache; }
+
+    VerificationCache *getVerificationCache() const { return this->verificationCache; }
+
+    /**
+     * @brief Ed25519 signs the message itself (PureEdDSA), hence no message digest is configured for it.
+     *
+     * @return const EVP_MD* digest used for signing and verification
+     */
+    const EVP_MD *getDigest() const { return this->isEd25519() ? nullptr : this->digest; }
+
+    /**
+     * @brief Change the digest of RSA signatures. Ignored by Ed25519 contexts.
+     *
+     * @param digestType digest to be used
+     */
+    void setDigest(DigestType digestType)
+    {
+        const EVP_MD *digest = getDigestByType(digestType);
+
+        if (digest != this->digest)
+        {
+            this->freeTemplates();
+            this->digest = digest;
+        }
+    }
+
+    static const EVP_MD *getDigestByType(DigestType digestType)
+    {
+        switch (digestType)
+        {
+        case Sha512_256Digest:
+            return EVP_sha512_256();
+        case Sha512Digest:
+            return EVP_sha512();
+        default:
+            return EVP_sha256();
+        }
+    }
+
+    /**
+     * @brief Get the key loaded into this context, if it is suitable for the signature algorithm
+     * the context was created for. The key is bound to the context (see bindKey), which keeps a
+     * reference to it until the key changes, even if a key handle rotates it meanwhile.
+     *
+     * @return EVP_PKEY* the key or nullptr
+     */
+    EVP_PKEY *getSuitableKey()
+    {
+        EVP_PKEY *pkey = this->getKey() ? static_cast<const AsymmetricKey *>(this->getKey())->acquire() : nullptr;
+        bool bound = this->isSuitableKey(pkey) and this->bindKey(pkey);
+
+        EVP_PKEY_free(pkey);
+
+        return bound ? this->templateKey : nullptr;
     }
 
+    /**
+     * @brief Verify a byte array created by createSignedData (i.e. data followed by signature) in place.
+     * It does not depend on any state of an EvpMdContext object, so it can be called concurrently
+     * as long as each thread provides its own digest context.
+     *
+     * @param mdContext digest context; it will be reset before use
+     * @param pkey verification key
+     * @param md digest used to create the signature
+     * @param in signed data
+     * @param inlen size of signed data
+     * @return true if signature is valid
+     */
+    static bool verifySignedData(EVP_MD_CTX *mdContext, EVP_PKEY *pkey, const EVP_MD *md, const unsigned char *in, unsigned int inlen);
+
+    /**
+     * @brief Verify a detached signature over data. Like verifySignedData, it can be called concurrently
+     * as long as each thread provides its own digest context.
+     *
+     * @param mdContext digest context; it will be reset before use
+     * @param pkey verification key
+     * @param md digest used to create the signature
+     * @param in signed data
+     * @param inlen size of signed data
+     * @param sig signature
+     * @param siglen size of signature
+     * @return true if signature is valid
+     */
+    static bool verifySignature(EVP_MD_CTX *mdContext, EVP_PKEY *pkey, const EVP_MD *md, const unsigned char *in, unsigned int inlen,
+                                const unsigned char *sig, unsigned int siglen);
+
     EncrypterResult *encrypt(const EncrypterData *in) override;
 
     EncrypterResult *decrypt(const EncrypterData *in) override;
 
+    /**
+     * @brief Verify a byte array created by createSignedData in place, without copying it.
+     *
+     * @param in signed data
+     * @param inlen size of signed data
+     * @return true if signature is valid
+     */
+    bool verify(const unsigned char *in, unsigned int inlen);
+
+    /**
+     * @brief Verify many signed byte arrays using the same key. Every item starts from a copy of
+     * the verification template, instead of initializing a digest context for each of them.
+     *
+     * @param in array of signed data buffers
+     * @param inlen array containing the size of each buffer
+     * @param count number of buffers
+     * @param results [Optional] if not null, results[i] holds the verification result for in[i]
+     * @return true if all signatures are valid
+     */
+    bool verifyBatch(const unsigned char **in, const unsigned int *inlen, unsigned int count, bool *results);
+
+    /**
+     * @brief Sign data without appending the signature to a copy of it.
+     *
+     * @param in data to be signed
+     * @param inlen size of data
+     * @param siglen size of the signature
+     * @return const unsigned char* signature, owned by this context and valid until its next operation
+     */
+    const unsigned char *signDetached(const unsigned char *in, unsigned int inlen, unsigned int &siglen);
+
+    /**
+     * @brief Verify a signature created by signDetached or signFinal.
+     *
+     * @param in signed data
+     * @param inlen size of signed data
+     * @param sig signature
+     * @param siglen size of signature
+     * @return true if signature is valid
+     */
+    bool verifyDetached(const unsigned char *in, unsigned int inlen, const unsigned char *sig, unsigned int siglen)
+    {
+        return this->verifyDetached(in, inlen, sig, siglen, this->verificationCache);
+    }
+
+    /**
+     * @brief Verify a detached signature, remembering successful verifications in the given cache
+     * instead of the one attached to this context.
+     *
+     * @param cache cache to be used or nullptr
+     * @return true if signature is valid
+     */
+    bool verifyDetached(const unsigned char *in, unsigned int inlen, const unsigned char *sig, unsigned int siglen, VerificationCache *cache);
+
+    /**
+     * @brief Sign a digest computed elsewhere, e.g. with ComputeSignatureDigest on another thread.
+     * The signature is identical to the one signDetached creates for the data the digest was computed from.
+     * Ed25519 signs messages rather than digests, hence this fails for Ed25519 contexts.
+     *
+     * @param digest SHA-256 digest of the data
+     * @param digestlen size of digest
+     * @param siglen size of the signature
+     * @return const unsigned char* signature, owned by this context and valid until its next operation
+     */
+    const unsigned char *signDigest(const unsigned char *digest, unsigned int digestlen, unsigned int &siglen);
+
+    /**
+     * @brief Verify a signature against a digest computed elsewhere.
+     *
+     * @param digest SHA-256 digest of the signed data
+     * @param digestlen size of digest
+     * @param sig signature
+     * @param siglen size of signature
+     * @return true if signature is valid
+     */
+    bool verifyDigest(const unsigned char *digest, unsigned int digestlen, const unsigned char *sig, unsigned int siglen);
+
+    /**
+     * @brief Start an incremental signature. Data is then fed with signUpdate and the signature
+     * is obtained with signFinal. Any other operation on this context aborts the incremental one.
+     * Ed25519 cannot sign incrementally, hence this fails for Ed25519 contexts.
+     *
+     * @return true on success
+     */
+    bool signInit();
+
+    bool signUpdate(const unsigned char *in, unsigned int inlen);
+
+    /**
+     * @brief Finish an incremental signature.
+     *
+     * @param siglen size of the signature
+     * @return const unsigned char* signature, owned by this context and valid until its next operation
+     */
+    const unsigned char *signFinal(unsigned int &siglen);
+
+    /**
+     * @brief Start an incremental verification of a detached signature. Data is then fed with
+     * verifyUpdate and the signature is checked by verifyFinal. As with signInit, Ed25519 is not supported.
+     *
+     * @return true on success
+     */
+    bool verifyInit();
+
+    bool verifyUpdate(const unsigned char *in, unsigned int inlen);
+
+    bool verifyFinal(const unsigned char *sig, unsigned int siglen);
+
+    /**
+     * @brief Reset the per-operation state. The digest context, the templates and the output buffer
+     * stay allocated for the next operation.
+     */
     void cleanup() override
     {
-        EvpContext::cleanup();
+        if (this->notNullMdContext())
+        {
+            EVP_MD_CTX_reset(this->mdContext);
+        }
 
-        this->freeMdContext();
-        this->freeInSig();
+        this->setOutBufferSize(0);
     }
 
     class Factory
@@ -112,9 +436,18 @@ public:
          * @brief Create new EvpMdContext to be used for signing or verification
          *
          * @param key AsymmetricKey object initialized accordingly
+         * @param digestType digest used for RSA signatures
+         * @return EvpContext* Newly created EvpMdContext
+         */
+        static EvpMdContext *create(Key *key, DigestType digestType = Sha256Digest) { return new EvpMdContext(key, EVP_PKEY_NONE, digestType); }
+
+        /**
+         * @brief Create new EvpMdContext to be used for Ed25519 signing or verification
+         *
+         * @param key AsymmetricKey object initialized with an Ed25519 key
          * @return EvpContext* Newly created EvpMdContext
          */
-        static EvpMdContext *create(Key *key) { return new EvpMdContext(key); }
+        static EvpMdContext *createEd25519(Key *key) { return new EvpMdContext(key, EVP_PKEY_ED25519); }
     };
 };
 
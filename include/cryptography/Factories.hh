@@ -2,6 +2,8 @@
 #define FACTORIES_HH
 
 #include "CryptoContext.hh"
+#include "KeyHandle.hh"
+#include "KeySet.hh"
 
 extern "C"
 {
@@ -9,6 +11,14 @@ extern "C"
 
     CryptoContext *CreateSymmetricDecryptionContext(const unsigned char *key);
 
+    /**
+     * @brief Create an AES encryption context whose key is derived from a master key for a purpose
+     * and a peer; the subkey never leaves the context. See MasterKey::deriveKey.
+     */
+    CryptoContext *CreateSymmetricEncryptionContextFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen);
+
+    CryptoContext *CreateSymmetricDecryptionContextFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen);
+
     CryptoContext *CreateAsymmetricEncryptionContext(const char *key);
 
     CryptoContext *CreateAsymmetricDecryptionContext(const char *key, const char *passphrase = nullptr);
@@ -25,6 +35,82 @@ extern "C"
 
     CryptoContext *CreateVerificationContextFromFile(const char *path);
 
+    CryptoContext *CreateSignatureContextWithDigest(const char *key, DigestType digestType, const char *passphrase = nullptr);
+
+    CryptoContext *CreateSignatureContextWithDigestFromFile(const char *path, DigestType digestType, const char *passphrase = nullptr);
+
+    CryptoContext *CreateEd25519SignatureContext(const char *key, const char *passphrase = nullptr);
+
+    CryptoContext *CreateEd25519VerificationContext(const char *key);
+
+    CryptoContext *CreateEd25519SignatureContextFromFile(const char *path, const char *passphrase = nullptr);
+
+    CryptoContext *CreateEd25519VerificationContextFromFile(const char *path);
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format);
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateSignatureContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateVerificationContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format);
+
+    CryptoContext *CreateEd25519SignatureContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateEd25519VerificationContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format);
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeyFile(const char *path, KeyFormat format);
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKeyFile(const char *path, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateSignatureContextFromKeyFile(const char *path, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateVerificationContextFromKeyFile(const char *path, KeyFormat format);
+
+    CryptoContext *CreateEd25519SignatureContextFromKeyFile(const char *path, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateEd25519VerificationContextFromKeyFile(const char *path, KeyFormat format);
+
+    /**
+     * @brief Create contexts sharing a key of a key set; lazy sets parse the key on first use.
+     */
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeySet(KeySet *keySet, const char *name);
+
+    CryptoContext *CreateVerificationContextFromKeySet(KeySet *keySet, const char *name);
+
+    CryptoContext *CreateEd25519VerificationContextFromKeySet(KeySet *keySet, const char *name);
+
+    /**
+     * @brief Create contexts sharing an existing key object (e.g. a generated key pair); the
+     * context holds its own reference, so the key object may be freed independently.
+     */
+    CryptoContext *CreateAsymmetricEncryptionContextFromKey(const AsymmetricKey *key);
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKey(const AsymmetricKey *key);
+
+    CryptoContext *CreateSignatureContextFromKey(const AsymmetricKey *key);
+
+    CryptoContext *CreateVerificationContextFromKey(const AsymmetricKey *key);
+
+    CryptoContext *CreateEd25519SignatureContextFromKey(const AsymmetricKey *key);
+
+    CryptoContext *CreateEd25519VerificationContextFromKey(const AsymmetricKey *key);
+
+    /**
+     * @brief Create contexts bound to a key handle; they follow its rotations without being rebuilt.
+     */
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeyHandle(const KeyHandle *handle);
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKeyHandle(const KeyHandle *handle);
+
+    CryptoContext *CreateSignatureContextFromKeyHandle(const KeyHandle *handle);
+
+    CryptoContext *CreateVerificationContextFromKeyHandle(const KeyHandle *handle);
+
+    CryptoContext *CreateEd25519SignatureContextFromKeyHandle(const KeyHandle *handle);
+
+    CryptoContext *CreateEd25519VerificationContextFromKeyHandle(const KeyHandle *handle);
+
     void FreeContext(CryptoContext *context);
 }
 
@@ -8,6 +8,14 @@
 class File
 {
 public:
+    /**
+     * @brief Read a whole file into a NUL-terminated buffer the caller releases with delete[].
+     * Use MappedFile to access a file without copying it.
+     *
+     * @param path path to the file
+     * @param len size of the content
+     * @return const char* content of the file or nullptr on failure
+     */
     static const char *readFile(const char *path, unsigned int &len);
 };
 
@@ -0,0 +1,57 @@
+#ifndef KEY_ADDRESS_HH
+#define KEY_ADDRESS_HH
+
+#include "AsymmetricKey.hh"
+
+#define HEX_ADDRESS_SIZE (2 * ADDRESS_SIZE + 1)
+
+extern "C"
+{
+    /**
+     * @brief Get the address of a key, as used by SealOnion and key directories; see
+     * AsymmetricKey::getAddress. The address is cached on the key object.
+     *
+     * @param key public or private key
+     * @param address output buffer of ADDRESS_SIZE bytes
+     * @return true on success
+     */
+    bool GetKeyAddress(const AsymmetricKey *key, unsigned char *address);
+
+    /**
+     * @brief Get the address of a key as a NUL-terminated, lowercase hex string.
+     *
+     * @param key public or private key
+     * @param hexAddress output buffer of HEX_ADDRESS_SIZE bytes
+     * @return true on success
+     */
+    bool GetKeyHexAddress(const AsymmetricKey *key, char *hexAddress);
+
+    /**
+     * @brief Get the address of a PEM public key. The key is parsed through the key cache, so
+     * deriving the address of a key in use by contexts does not parse it again.
+     */
+    bool GetPemAddress(const char *pem, unsigned char *address);
+
+    bool GetPemHexAddress(const char *pem, char *hexAddress);
+
+    /**
+     * @brief Derive the addresses of many keys on the process-wide worker pool. Addresses already
+     * cached on a key object are not computed again.
+     *
+     * @param keys array of keys
+     * @param count number of keys
+     * @param addresses output buffer of count * ADDRESS_SIZE bytes
+     * @param results [Optional] output array: results[i] is true if the address of keys[i] was derived
+     * @return true if every address was derived
+     */
+    bool GetKeyAddresses(const AsymmetricKey **keys, unsigned int count, unsigned char *addresses, bool *results);
+
+    /**
+     * @brief Derive the addresses of many PEM public keys on the process-wide worker pool.
+     *
+     * @see GetKeyAddresses
+     */
+    bool GetPemAddresses(const char **pems, unsigned int count, unsigned char *addresses, bool *results);
+}
+
+#endif
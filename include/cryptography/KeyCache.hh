@@ -0,0 +1,143 @@
+#ifndef KEY_CACHE_HH
+#define KEY_CACHE_HH
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <openssl/evp.h>
+
+#include "enums/KeyFormat.hh"
+
+#define KEY_CACHE_DIGEST_SIZE 32
+#define KEY_CACHE_DEFAULT_CAPACITY 1024
+
+/**
+ * @brief Cache of parsed keys, indexed by the SHA-256 of their PEM or DER encoding. The process has
+ * one instance for public keys and an opt-in one for unlocked private keys.
+ * Keys are shared by reference counting: lookups return a new reference the caller must release
+ * with EVP_PKEY_free, and evicted keys stay alive for as long as a context still uses them.
+ * The least recently used key is evicted when the capacity is reached. All methods are thread-safe.
+ */
+class KeyCache
+{
+    typedef std::list<std::string> UsageList;
+
+    struct Entry
+    {
+        EVP_PKEY *pkey;
+        UsageList::iterator usage;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    UsageList usage;
+
+    std::atomic<unsigned int> capacity;
+
+    std::atomic<unsigned long> hits;
+    std::atomic<unsigned long> misses;
+    std::atomic<unsigned long> evictions;
+
+    KeyCache(const KeyCache &);
+    const KeyCache &operator=(const KeyCache &);
+
+    KeyCache(unsigned int capacity)
+    {
+        this->capacity = capacity;
+        this->hits = 0;
+        this->misses = 0;
+        this->evictions = 0;
+    }
+
+    void erase(std::unordered_map<std::string, Entry>::iterator entry)
+    {
+        EVP_PKEY_free(entry->second.pkey);
+        this->usage.erase(entry->second.usage);
+        this->entries.erase(entry);
+    }
+
+    void evict(unsigned int size);
+
+public:
+    /**
+     * @brief Compute the digest a key is cached under. The format and the passphrase take part in
+     * the digest, so the same bytes given in different formats are never mistaken for one another
+     * and an encrypted private key is only found again with the passphrase that unlocked it.
+     *
+     * @param keyData encoded key
+     * @param len size of keyData
+     * @param format encoding of keyData
+     * @param passphrase passphrase used to unlock keyData, or nullptr
+     * @param digest output buffer of KEY_CACHE_DIGEST_SIZE bytes
+     * @return true on success
+     */
+    static bool computeDigest(const unsigned char *keyData, unsigned int len, KeyFormat format, const char *passphrase, unsigned char *digest);
+
+    /**
+     * @brief Look up a key. Counts a hit or a miss.
+     *
+     * @param digest digest computed by computeDigest
+     * @return EVP_PKEY* new reference to the cached key or nullptr
+     */
+    EVP_PKEY *get(const unsigned char *digest);
+
+    /**
+     * @brief Cache a key; the cache takes its own reference to it.
+     *
+     * @param digest digest computed by computeDigest
+     * @param pkey parsed key
+     */
+    void put(const unsigned char *digest, EVP_PKEY *pkey);
+
+    void clear();
+
+    void setCapacity(unsigned int capacity);
+
+    unsigned int getCapacity() const { return this->capacity; }
+
+    unsigned int getSize();
+
+    unsigned long getHits() const { return this->hits; }
+
+    unsigned long getMisses() const { return this->misses; }
+
+    unsigned long getEvictions() const { return this->evictions; }
+
+    /**
+     * @brief Get the process-wide cache of parsed public keys.
+     */
+    static KeyCache *getInstance();
+
+    /**
+     * @brief Get the process-wide cache of unlocked private keys. It is empty with capacity 0 unless
+     * enabled, since it keeps decrypted private keys in memory beyond the contexts using them.
+     */
+    static KeyCache *getUnlockedInstance();
+};
+
+extern "C"
+{
+    /**
+     * @brief Set the number of public keys kept parsed. 0 disables the cache.
+     */
+    void SetKeyCacheCapacity(unsigned int capacity);
+
+    void ClearKeyCache();
+
+    void GetKeyCacheStats(unsigned long &hits, unsigned long &misses, unsigned long &evictions, unsigned int &size);
+
+    /**
+     * @brief Set the number of private keys kept unlocked, so that the passphrase key derivation
+     * runs once per key and passphrase. 0, the default, disables the cache and wipes its keys.
+     */
+    void SetUnlockedKeyCacheCapacity(unsigned int capacity);
+
+    void ClearUnlockedKeyCache();
+
+    void GetUnlockedKeyCacheStats(unsigned long &hits, unsigned long &misses, unsigned long &evictions, unsigned int &size);
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef KEY_DIRECTORY_HH
+#define KEY_DIRECTORY_HH
+
+#include "AsymmetricKey.hh"
+#include "MappedFile.hh"
+
+#include <mutex>
+#include <unordered_map>
+
+#define KEY_DIRECTORY_HEADER_SIZE 16
+#define KEY_DIRECTORY_ENTRY_SIZE 44
+
+/**
+ * @brief Directory of public keys indexed by their 32-byte address, read from a file that is
+ * memory-mapped and never copied, so that processes using the same directory share its pages.
+ *
+ * The file holds a header (magic, big-endian 64-bit entry count), the index sorted by address,
+ * each entry being the address, the big-endian 64-bit offset and 32-bit size of the key, and the
+ * DER (SubjectPublicKeyInfo) encoded keys. Opening a directory only checks the header and the
+ * size of the index; a key is looked up by binary search, parsed on first use and kept parsed
+ * for the lifetime of the directory. All methods are thread-safe.
+ */
+class KeyDirectory
+{
+    MappedFile *file;
+    unsigned long count;
+
+    std::mutex mutex;
+    std::unordered_map<unsigned long, AsymmetricKey *> keys;
+
+    KeyDirectory(const KeyDirectory &);
+    const KeyDirectory &operator=(const KeyDirectory &);
+
+    KeyDirectory(MappedFile *file)
+    {
+        this->file = file;
+        this->count = 0;
+    }
+
+    bool readHeader();
+
+    const unsigned char *getEntry(unsigned long index) const
+    {
+        return this->file->getData() + KEY_DIRECTORY_HEADER_SIZE + index * KEY_DIRECTORY_ENTRY_SIZE;
+    }
+
+public:
+    ~KeyDirectory();
+
+    unsigned long getSize() const { return this->count; }
+
+    /**
+     * @brief Find the index of an address by binary search.
+     *
+     * @param address ADDRESS_SIZE bytes
+     * @param index output: index of the entry
+     * @return true if the address is in the directory
+     */
+    bool find(const unsigned char *address, unsigned long &index) const;
+
+    /**
+     * @brief Get the DER encoding of a key as stored in the directory, without parsing it.
+     *
+     * @param address ADDRESS_SIZE bytes
+     * @param len output: size of the key
+     * @return const unsigned char* pointer into the mapping or nullptr if the address is unknown
+     * or its entry points outside the file
+     */
+    const unsigned char *getKeyData(const unsigned char *address, unsigned int &len) const;
+
+    /**
+     * @brief Get the key of an address, parsing it on first use.
+     *
+     * @param address ADDRESS_SIZE bytes
+     * @return const AsymmetricKey* key owned by the directory or nullptr if the address is unknown
+     * or its key is invalid
+     */
+    const AsymmetricKey *getKey(const unsigned char *address);
+
+    /**
+     * @brief Write a directory file. Entries may be given in any order; the file is written under
+     * a temporary name and renamed, so processes still mapping a previous version are unaffected.
+     *
+     * @param path path to the directory file
+     * @param addresses array of count addresses of ADDRESS_SIZE bytes, all distinct
+     * @param keys array of DER encoded public keys
+     * @param keyLens array containing the size of each key
+     * @param count number of keys
+     * @return true on success
+     */
+    static bool write(const char *path, const unsigned char **addresses, const unsigned char **keys, const unsigned int *keyLens, unsigned long count);
+
+    class Factory
+    {
+    public:
+        /**
+         * @brief Open a directory file.
+         *
+         * @param path path to the directory file
+         * @return KeyDirectory* pointer to newly created object or nullptr if the file cannot be
+         * mapped or is not a directory file
+         */
+        static KeyDirectory *create(const char *path);
+    };
+};
+
+extern "C"
+{
+    /**
+     * @brief Write a key directory file; see KeyDirectory::write.
+     */
+    bool WriteKeyDirectory(const char *path, const unsigned char **addresses, const unsigned char **keys, const unsigned int *keyLens, unsigned long count);
+
+    KeyDirectory *OpenKeyDirectory(const char *path);
+
+    void FreeKeyDirectory(KeyDirectory *directory);
+
+    unsigned long GetKeyDirectorySize(const KeyDirectory *directory);
+}
+
+#endif
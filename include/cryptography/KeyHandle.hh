@@ -0,0 +1,112 @@
+#ifndef KEY_HANDLE_HH
+#define KEY_HANDLE_HH
+
+#include "AsymmetricKey.hh"
+
+#include <atomic>
+#include <mutex>
+
+/**
+ * @brief Rotatable reference to an asymmetric key. Keys bound to the handle (and so the contexts
+ * using them) switch to a rotated key on their next operation; operations already running keep
+ * the key they started with, which stays alive until its last user releases it.
+ *
+ * Readers never lock: they check an atomic version and, only after a rotation, take a reference
+ * to the new key inside a read-side critical section tracked by two epoch counters. rotate() waits
+ * for the critical sections of the previous epoch (a few instructions each) before dropping the
+ * handle's reference to the old key. Rotations must keep the algorithm and size of the key.
+ */
+class KeyHandle
+{
+    KeyType keyType;
+
+    std::atomic<EVP_PKEY *> current;
+    std::atomic<unsigned long> version;
+
+    mutable std::atomic<unsigned long> epoch;
+    mutable std::atomic<unsigned long> readers[2];
+
+    std::mutex rotation;
+
+    KeyHandle(const KeyHandle &);
+    const KeyHandle &operator=(const KeyHandle &);
+
+    KeyHandle(KeyType keyType)
+    {
+        this->keyType = keyType;
+        this->current = nullptr;
+        this->version = 0;
+        this->epoch = 0;
+        this->readers[0] = 0;
+        this->readers[1] = 0;
+    }
+
+public:
+    ~KeyHandle() { EVP_PKEY_free(this->current); }
+
+    KeyType getKeyType() const { return this->keyType; }
+
+    /**
+     * @brief Get the number of rotations so far; it changes whenever the key does.
+     */
+    unsigned long getVersion() const { return this->version; }
+
+    /**
+     * @brief Take a reference to the current key.
+     *
+     * @param version set to the version of the returned key
+     * @return EVP_PKEY* new reference the caller releases with EVP_PKEY_free
+     */
+    EVP_PKEY *acquire(unsigned long &version) const;
+
+    /**
+     * @brief Make the handle refer to the key of another key object of the same type, algorithm and size.
+     *
+     * @param key new key
+     * @return true if the key was rotated
+     */
+    bool rotate(const AsymmetricKey *key);
+
+    class Factory
+    {
+    public:
+        /**
+         * @brief Create a handle referring to the key of a key object.
+         *
+         * @param key initial key
+         * @return KeyHandle* pointer to newly created object or nullptr if key is not set
+         */
+        static KeyHandle *create(const AsymmetricKey *key)
+        {
+            KeyHandle *handle = key ? new KeyHandle(key->getKeyType()) : nullptr;
+
+            if (handle and not handle->rotate(key))
+            {
+                delete handle;
+                return nullptr;
+            }
+
+            return handle;
+        }
+    };
+};
+
+extern "C"
+{
+    KeyHandle *CreateKeyHandle(const AsymmetricKey *key);
+
+    /**
+     * @brief Rotate the key of a handle to a key of the same algorithm and size; contexts created from
+     * the handle use the new key for their next operation. The handle keeps its own reference, so key may be freed afterwards.
+     */
+    bool RotateKey(KeyHandle *handle, const AsymmetricKey *key);
+
+    unsigned long GetKeyHandleVersion(const KeyHandle *handle);
+
+    /**
+     * @brief Release a handle. It must outlive every context created from it.
+     */
+    void FreeKeyHandle(KeyHandle *handle);
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef KEY_PAIR_POOL_HH
+#define KEY_PAIR_POOL_HH
+
+#include "AsymmetricKey.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Stock of pre-generated private keys of one algorithm and size. Background threads keep
+ * up to depth keys ready, so taking a key usually costs a lock instead of a key generation; when
+ * the stock is empty the key is generated on the calling thread. All methods are thread-safe.
+ */
+class KeyPairPool
+{
+    KeyPairType type;
+    unsigned int bits;
+    unsigned int depth;
+
+    std::mutex mutex;
+    std::condition_variable refill;
+    std::deque<AsymmetricKey *> keys;
+    std::vector<std::thread> workers;
+    unsigned int pending;
+    bool stopping;
+
+    std::atomic<unsigned long> hits;
+    std::atomic<unsigned long> misses;
+
+    KeyPairPool(const KeyPairPool &);
+    const KeyPairPool &operator=(const KeyPairPool &);
+
+    void work();
+
+public:
+    /**
+     * @param type algorithm of the keys
+     * @param bits modulus size for RSA keys; ignored otherwise
+     * @param depth number of keys kept ready
+     * @param threads number of background generator threads
+     */
+    KeyPairPool(KeyPairType type, unsigned int bits, unsigned int depth, unsigned int threads);
+
+    ~KeyPairPool();
+
+    /**
+     * @brief Take a private key out of the pool; counts a hit if it was pre-generated.
+     *
+     * @return AsymmetricKey* private key owned by the caller or nullptr if generation fails
+     */
+    AsymmetricKey *take();
+
+    unsigned int getSize();
+
+    unsigned int getDepth() const { return this->depth; }
+
+    unsigned long getHits() const { return this->hits; }
+
+    unsigned long getMisses() const { return this->misses; }
+};
+
+extern "C"
+{
+    /**
+     * @brief Generate a private key in process; see AsymmetricKey::Factory::generatePrivateKey.
+     */
+    AsymmetricKey *GenerateKeyPair(KeyPairType type, unsigned int bits);
+
+    /**
+     * @brief Get the public half of a private key as a new public key object.
+     */
+    AsymmetricKey *GetPublicKey(const AsymmetricKey *privateKey);
+
+    /**
+     * @brief Encode a key; see AsymmetricKey::exportKey. The returned buffer is owned by the caller.
+     */
+    const unsigned char *ExportKey(const AsymmetricKey *key, KeyFormat format, const char *passphrase, int &len);
+
+    void FreeKey(AsymmetricKey *key);
+
+    KeyPairPool *CreateKeyPairPool(KeyPairType type, unsigned int bits, unsigned int depth, unsigned int threads);
+
+    AsymmetricKey *TakeKeyPair(KeyPairPool *pool);
+
+    void FreeKeyPairPool(KeyPairPool *pool);
+
+    bool GetKeyPairPoolStats(KeyPairPool *pool, unsigned long &hits, unsigned long &misses, unsigned int &size);
+}
+
+#endif
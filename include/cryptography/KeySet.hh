@@ -0,0 +1,150 @@
+#ifndef KEY_SET_HH
+#define KEY_SET_HH
+
+#include "AsymmetricKey.hh"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Progress callback of a key set load; it is called from the worker threads after each key.
+ */
+typedef void (*KeySetProgress)(unsigned int loaded, unsigned int total, void *arg);
+
+/**
+ * @brief Named set of public keys read from the files of a directory or from the paths listed in
+ * a manifest. Keys are parsed once, either eagerly on the process-wide worker pool or lazily on
+ * first use, and are shared by every context created from the set. All methods are thread-safe.
+ */
+class KeySet
+{
+    struct Entry
+    {
+        std::string name;
+        std::string path;
+        std::once_flag parsed;
+        AsymmetricKey *key;
+    };
+
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::unordered_map<std::string, unsigned int> index;
+    KeyFormat format;
+
+    std::atomic<unsigned int> loaded;
+    std::atomic<unsigned int> failed;
+    unsigned long loadTime;
+
+    KeySet(const KeySet &);
+    const KeySet &operator=(const KeySet &);
+
+    KeySet(KeyFormat format)
+    {
+        this->format = format;
+        this->loaded = 0;
+        this->failed = 0;
+        this->loadTime = 0;
+    }
+
+    void add(const std::string &name, const std::string &path);
+
+    bool listDirectory(const char *path);
+
+    bool readManifest(const char *path);
+
+    const AsymmetricKey *parse(Entry &entry);
+
+    void load(KeySetProgress progress, void *arg);
+
+public:
+    ~KeySet();
+
+    unsigned int getSize() const { return this->entries.size(); }
+
+    /**
+     * @brief Get the number of keys parsed so far, successfully or not.
+     */
+    unsigned int getLoadedCount() const { return this->loaded; }
+
+    unsigned int getFailedCount() const { return this->failed; }
+
+    /**
+     * @brief Get the wall-clock time spent parsing keys eagerly, in microseconds; 0 for lazy sets.
+     */
+    unsigned long getLoadTime() const { return this->loadTime; }
+
+    const char *getName(unsigned int index) const
+    {
+        return index < this->entries.size() ? this->entries[index]->name.c_str() : nullptr;
+    }
+
+    /**
+     * @brief Get a key by name, parsing it first if the set is lazy.
+     *
+     * @param name file name of the key (directory) or path as listed (manifest)
+     * @return const AsymmetricKey* the key or nullptr if it is unknown or invalid
+     */
+    const AsymmetricKey *getKey(const char *name);
+
+    const AsymmetricKey *getKey(unsigned int index);
+
+    class Factory
+    {
+    public:
+        /**
+         * @brief Create a set of all regular, non-hidden files of a directory, named by file name.
+         *
+         * @param path directory holding one public key per file
+         * @param format format of the key files
+         * @param lazy parse every key on first use instead of up front
+         * @param progress [Optional] callback invoked after each key parsed up front
+         * @param arg [Optional] argument passed to progress
+         * @return KeySet* pointer to newly created object or nullptr if the directory cannot be read
+         */
+        static KeySet *createFromDirectory(const char *path, KeyFormat format, bool lazy, KeySetProgress progress = nullptr, void *arg = nullptr);
+
+        /**
+         * @brief Create a set of the key files listed in a manifest, one path per line; relative paths
+         * are resolved against the directory of the manifest, empty lines and lines starting with '#'
+         * are ignored. Keys are named by the path as listed.
+         *
+         * @param path manifest file
+         * @param format format of the key files
+         * @param lazy parse every key on first use instead of up front
+         * @param progress [Optional] callback invoked after each key parsed up front
+         * @param arg [Optional] argument passed to progress
+         * @return KeySet* pointer to newly created object or nullptr if the manifest cannot be read
+         */
+        static KeySet *createFromManifest(const char *path, KeyFormat format, bool lazy, KeySetProgress progress = nullptr, void *arg = nullptr);
+    };
+};
+
+extern "C"
+{
+    /**
+     * @brief Load every key file of a directory; see KeySet::Factory::createFromDirectory.
+     */
+    KeySet *LoadKeySetFromDirectory(const char *path, KeyFormat format, bool lazy, KeySetProgress progress = nullptr, void *arg = nullptr);
+
+    /**
+     * @brief Load the key files listed in a manifest; see KeySet::Factory::createFromManifest.
+     */
+    KeySet *LoadKeySetFromManifest(const char *path, KeyFormat format, bool lazy, KeySetProgress progress = nullptr, void *arg = nullptr);
+
+    void FreeKeySet(KeySet *keySet);
+
+    unsigned int GetKeySetSize(const KeySet *keySet);
+
+    const char *GetKeySetKeyName(const KeySet *keySet, unsigned int index);
+
+    /**
+     * @brief Get the number of keys parsed so far, how many of them failed to parse and the time
+     * the up-front load took in microseconds.
+     */
+    bool GetKeySetStats(const KeySet *keySet, unsigned int &loaded, unsigned int &failed, unsigned long &loadTime);
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef MAPPED_FILE_HH
+#define MAPPED_FILE_HH
+
+/**
+ * @brief Read-only view of a whole file mapped into memory. The content is paged in on demand
+ * and never copied; the view stays valid until the object is destroyed.
+ */
+class MappedFile
+{
+    const unsigned char *data;
+    unsigned long size;
+
+    MappedFile(const MappedFile &);
+    const MappedFile &operator=(const MappedFile &);
+
+    MappedFile()
+    {
+        this->data = nullptr;
+        this->size = 0;
+    }
+
+    bool map(const char *path, bool readAhead);
+
+public:
+    ~MappedFile();
+
+    /**
+     * @brief Get the content of the file; nullptr for an empty file.
+     */
+    const unsigned char *getData() const { return this->data; }
+
+    unsigned long getSize() const { return this->size; }
+
+    /**
+     * @brief Tell the kernel how the mapping is about to be accessed, overriding the sequential or
+     * random access advice given when the file was mapped.
+     *
+     * @param advice one of the madvise(2) advice values
+     * @return true on success or for an empty file
+     */
+    bool advise(int advice) const;
+
+    class Factory
+    {
+    public:
+        /**
+         * @brief Map a file read-only and, unless told otherwise, ask the kernel to read it ahead.
+         *
+         * @param path path to the file
+         * @param readAhead [Optional] advise sequential access and start reading the whole file;
+         * false for files accessed at random, which are then paged in on demand only
+         * @return MappedFile* pointer to newly created object or nullptr if the file cannot be mapped
+         */
+        static MappedFile *create(const char *path, bool readAhead = true)
+        {
+            MappedFile *file = new MappedFile();
+
+            if (not file->map(path, readAhead))
+            {
+                delete file;
+                return nullptr;
+            }
+
+            return file;
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef MASTER_KEY_HH
+#define MASTER_KEY_HH
+
+#include "Constants.hh"
+
+#include <openssl/kdf.h>
+
+#define MASTER_KEY_MAX_INFO_SIZE 1024
+
+class CryptoContext;
+
+/**
+ * @brief Master key from which symmetric subkeys are derived with HKDF-SHA256 (RFC 5869), so that
+ * one stored secret replaces a key per peer and purpose.
+ *
+ * The pseudorandom key is extracted once, when the object is created; every subkey then costs a
+ * single HKDF-Expand with info = purpose | 0x00 | peer. The pseudorandom key is wiped on destruction.
+ * All methods are thread-safe.
+ */
+class MasterKey
+{
+    EVP_KDF *kdf;
+    unsigned char prk[SYMMETRIC_KEY_SIZE];
+
+    MasterKey(const MasterKey &);
+    const MasterKey &operator=(const MasterKey &);
+
+    MasterKey()
+    {
+        this->kdf = nullptr;
+    }
+
+    bool extract(const unsigned char *key, unsigned int keyLen, const unsigned char *salt, unsigned int saltLen);
+
+public:
+    ~MasterKey();
+
+    /**
+     * @brief Derive the subkey of a purpose and a peer.
+     *
+     * @param purpose NUL-terminated label of what the subkey is used for, e.g. "transport"
+     * @param peer [Optional] identifier of the peer, e.g. its address
+     * @param peerLen size of peer
+     * @param subkey output buffer of SYMMETRIC_KEY_SIZE bytes
+     * @return true on success
+     */
+    bool deriveKey(const char *purpose, const unsigned char *peer, unsigned int peerLen, unsigned char *subkey) const;
+
+    class Factory
+    {
+    public:
+        /**
+         * @brief Create a master key.
+         *
+         * @param key input keying material, at least SYMMETRIC_KEY_SIZE bytes
+         * @param keyLen size of key
+         * @param salt [Optional] non-secret salt
+         * @param saltLen size of salt
+         * @return MasterKey* pointer to newly created object or nullptr on error
+         */
+        static MasterKey *create(const unsigned char *key, unsigned int keyLen, const unsigned char *salt = nullptr, unsigned int saltLen = 0);
+    };
+};
+
+extern "C"
+{
+    /**
+     * @brief Create a master key; see MasterKey::Factory::create.
+     */
+    MasterKey *CreateMasterKey(const unsigned char *key, unsigned int keyLen, const unsigned char *salt, unsigned int saltLen);
+
+    void FreeMasterKey(MasterKey *masterKey);
+
+    /**
+     * @brief Derive a subkey into caller memory, e.g. to hand it to another library. Prefer the
+     * context factories, which derive the subkey directly into the context.
+     *
+     * @param subkey output buffer of SYMMETRIC_KEY_SIZE bytes
+     */
+    bool DeriveSubkey(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen, unsigned char *subkey);
+
+    /**
+     * @brief Create AES encryption contexts for many peers at once, on the process-wide worker pool.
+     * The subkey of every peer is derived directly into its context.
+     *
+     * @param masterKey master key
+     * @param purpose label shared by all subkeys
+     * @param peers array of peer identifiers
+     * @param peerLens array containing the size of each peer identifier
+     * @param count number of peers
+     * @param ctx output array of count contexts; contexts that could not be created are nullptr
+     * @return true if every context was created
+     */
+    bool CreateSymmetricEncryptionContextsFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char **peers, const unsigned int *peerLens, unsigned int count, CryptoContext **ctx);
+
+    bool CreateSymmetricDecryptionContextsFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char **peers, const unsigned int *peerLens, unsigned int count, CryptoContext **ctx);
+}
+
+#endif
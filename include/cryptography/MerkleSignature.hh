@@ -0,0 +1,77 @@
+#ifndef MERKLE_SIGNATURE_HH
+#define MERKLE_SIGNATURE_HH
+
+#include "CryptoContext.hh"
+#include "MerkleTree.hh"
+
+/**
+ * Merkle signature structure
+ * 1. Magic "AMT1" (4 bytes)
+ * 2. Leaf size (4 bytes, big endian)
+ * 3. Data size (8 bytes, big endian)
+ * 4. Merkle root (32 bytes)
+ * 5. Signature over fields 1-4
+ */
+#define MERKLE_SIGNATURE_HEADER_SIZE 48
+
+/**
+ * Batch signature structure, one per message of the batch
+ * 1. Magic "AMB1" (4 bytes)
+ * 2. Number of messages in the batch (8 bytes, big endian)
+ * 3. Merkle root (32 bytes)
+ * 4. Size of root signature (4 bytes, big endian)
+ * 5. Root signature over fields 1-3
+ * 6. Index of the message (8 bytes, big endian)
+ * 7. Inclusion proof of the message
+ */
+#define BATCH_SIGNATURE_HEADER_SIZE 48
+#define BATCH_SIGNATURE_SIGNED_SIZE 44
+#define BATCH_SIGNATURE_INDEX_SIZE 8
+
+extern "C"
+{
+    MerkleTree *CreateMerkleTree(const unsigned char *data, unsigned long dataLen, unsigned int leafSize);
+
+    void FreeMerkleTree(MerkleTree *tree);
+
+    /**
+     * @brief Get the inclusion proof of leaf index. The returned buffer is owned by the caller.
+     */
+    const unsigned char *GetMerkleProof(const MerkleTree *tree, unsigned long index, int &proofLen);
+
+    /**
+     * @brief Sign the root of a Merkle tree. The returned buffer is owned by the caller.
+     */
+    const unsigned char *SignMerkleTree(CryptoContext *ctx, const MerkleTree *tree, int &signatureLen);
+
+    /**
+     * @brief Hash data as a Merkle tree of leafSize leaves, in parallel, and sign its root.
+     * The returned buffer is owned by the caller.
+     */
+    const unsigned char *SignDataMerkle(CryptoContext *ctx, const unsigned char *data, unsigned long dataLen, unsigned int leafSize, int &signatureLen);
+
+    bool VerifyDataMerkle(CryptoContext *ctx, const unsigned char *data, unsigned long dataLen, const unsigned char *signature, unsigned int signatureLen);
+
+    /**
+     * @brief Verify a single leaf of signed data using its inclusion proof, without the rest of the data.
+     */
+    bool VerifyMerkleChunk(CryptoContext *ctx, const unsigned char *chunk, unsigned int chunkLen, unsigned long index,
+                           const unsigned char *proof, unsigned int proofLen, const unsigned char *signature, unsigned int signatureLen);
+
+    /**
+     * @brief Sign count messages with a single private-key operation over the root of a Merkle tree
+     * with one leaf per message. The batch signature of message i is written to signatures[i] and its size
+     * to signatureLens[i]; all of them point into the returned buffer, which is owned by the caller.
+     */
+    const unsigned char *SignBatch(CryptoContext *ctx, const unsigned char **messages, const unsigned int *messageLens, unsigned int count,
+                                   const unsigned char **signatures, unsigned int *signatureLens, int &totalLen);
+
+    /**
+     * @brief Verify one message against its batch signature. If a verification cache is attached to
+     * the context (see SetVerificationCache), verified roots are remembered in it, so the other
+     * messages of the same batch only cost their inclusion proof.
+     */
+    bool VerifyBatchSignature(CryptoContext *ctx, const unsigned char *message, unsigned int messageLen, const unsigned char *signature, unsigned int signatureLen);
+}
+
+#endif
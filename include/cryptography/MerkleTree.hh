@@ -0,0 +1,107 @@
+#ifndef MERKLE_TREE_HH
+#define MERKLE_TREE_HH
+
+#include <functional>
+#include <vector>
+
+#define MERKLE_HASH_SIZE 32
+#define MERKLE_DEFAULT_LEAF_SIZE 1048576
+
+/**
+ * @brief SHA-256 Merkle tree over fixed-size leaves of a byte array.
+ *
+ * Leaf hashes are SHA-256(0x00 | leaf) and inner hashes SHA-256(0x01 | left | right), so a leaf can never
+ * be passed off as an inner node. A node without a right sibling is promoted to the next level unchanged.
+ * Empty data is a single empty leaf. A tree can also be built with one leaf per message of a batch.
+ */
+class MerkleTree
+{
+    unsigned int leafSize;
+    unsigned long dataLen;
+    unsigned long leafCount;
+
+    // levels[0] holds leaf hashes, the last level holds the root only;
+    std::vector<std::vector<unsigned char>> levels;
+
+    MerkleTree(const MerkleTree &);
+    const MerkleTree &operator=(const MerkleTree &);
+
+    MerkleTree(unsigned int leafSize, unsigned long dataLen, unsigned long leafCount)
+    {
+        this->leafSize = leafSize;
+        this->dataLen = dataLen;
+        this->leafCount = leafCount;
+    }
+
+    /**
+     * @brief Hash all leaves on the process-wide worker pool.
+     *
+     * @param leavesPerTask number of leaves hashed by a single task
+     * @param getLeaf function returning the bytes of leaf i
+     * @return true on success
+     */
+    bool hashLeaves(unsigned long leavesPerTask, const std::function<void(unsigned long, const unsigned char *&, unsigned int &)> &getLeaf);
+
+    bool hashLevels();
+
+public:
+    unsigned int getLeafSize() const { return this->leafSize; }
+
+    unsigned long getDataLen() const { return this->dataLen; }
+
+    unsigned long getLeafCount() const { return this->leafCount; }
+
+    const unsigned char *getRoot() const { return this->levels.back().data(); }
+
+    /**
+     * @brief Get the sibling hashes from leaf index up to the root, leaf level first.
+     *
+     * @param index index of the leaf
+     * @param proof output: concatenated sibling hashes
+     * @return true if index is a valid leaf index
+     */
+    bool getProof(unsigned long index, std::vector<unsigned char> &proof) const;
+
+    static unsigned long getLeafCount(unsigned long dataLen, unsigned int leafSize)
+    {
+        return dataLen ? (dataLen + leafSize - 1) / leafSize : 1;
+    }
+
+    static bool hashLeaf(const unsigned char *leaf, unsigned int leafLen, unsigned char *hash);
+
+    static bool hashNode(const unsigned char *left, const unsigned char *right, unsigned char *hash);
+
+    /**
+     * @brief Compute the root of a tree with leafCount leaves from a leaf hash and its inclusion proof.
+     *
+     * @return true if the proof has exactly the size the position of the leaf requires
+     */
+    static bool computeRoot(const unsigned char *leafHash, unsigned long index, unsigned long leafCount,
+                            const unsigned char *proof, unsigned int proofLen, unsigned char *root);
+
+    class Factory
+    {
+    public:
+        /**
+         * @brief Build the tree, hashing leaves in parallel on the process-wide worker pool.
+         *
+         * @param data data to be hashed
+         * @param dataLen size of data
+         * @param leafSize size of every leaf but the last one
+         * @return MerkleTree* the tree or nullptr on error
+         */
+        static MerkleTree *create(const unsigned char *data, unsigned long dataLen, unsigned int leafSize);
+
+        /**
+         * @brief Build a tree with one leaf per message, hashing messages in parallel.
+         *
+         * @param messages array of messages
+         * @param messageLens array containing the size of each message
+         * @param count number of messages, at least 1
+         * @return MerkleTree* the tree or nullptr on error
+         */
+        static MerkleTree *createFromMessages(const unsigned char **messages, const unsigned int *messageLens, unsigned long count);
+    };
+};
+
+#endif
@@ -1,6 +1,46 @@
 #ifndef ONION_BUILDING_HH
 #define ONION_BUILDING_HH
 
-extern "C" const unsigned char *SealOnion(const unsigned char *plaintext, unsigned int plaintextLen, const char **keys, const char **addresses, unsigned int count, int &outLen);
+#include "OnionRoute.hh"
+
+extern "C"
+{
+    /**
+     * @brief Seal an onion over a route used once. Use an OnionRoute to send more than one message
+     * over the same hops.
+     *
+     * @param keys array of count PEM public keys, the first hop being the innermost layer
+     * @param addresses array of count hex-encoded addresses
+     * @return const unsigned char* the onion or nullptr if a key or an address is invalid
+     */
+    const unsigned char *SealOnion(const unsigned char *plaintext, unsigned int plaintextLen, const char **keys, const char **addresses, unsigned int count, int &outLen);
+
+    /**
+     * @brief Seal an onion in the given format; OnionFormatV2 lifts the 65,535-byte limit on layers,
+     * so that a payload of several megabytes costs one RSA operation per hop.
+     *
+     * @see SealOnion
+     */
+    const unsigned char *SealOnionWithFormat(const unsigned char *plaintext, unsigned int plaintextLen, const char **keys, const char **addresses, unsigned int count, OnionFormat format, int &outLen);
+
+    /**
+     * @brief Seal an onion for the hops given by address only, looking up their keys in a key
+     * directory. Keys are parsed once per directory and shared by the layers.
+     *
+     * @param directory key directory holding the key of every hop
+     * @param addresses array of count hex-encoded addresses, as for SealOnion
+     * @return const unsigned char* the onion or nullptr if an address is unknown or invalid
+     */
+    const unsigned char *SealOnionWithKeyDirectory(const unsigned char *plaintext, unsigned int plaintextLen, KeyDirectory *directory, const char **addresses, unsigned int count, int &outLen);
+
+    /**
+     * @brief Seal an onion over a prepared route; no key is parsed and no address decoded.
+     *
+     * @see OnionRoute::seal
+     */
+    const unsigned char *SealOnionWithRoute(OnionRoute *route, const unsigned char *plaintext, unsigned int plaintextLen, int &outLen);
+
+    const unsigned char *SealOnionWithRouteAndFormat(OnionRoute *route, const unsigned char *plaintext, unsigned int plaintextLen, OnionFormat format, int &outLen);
+}
 
 #endif
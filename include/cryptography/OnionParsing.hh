@@ -2,12 +2,43 @@
 #define ONION_PARSING_HH
 
 #include "CryptoContext.hh"
+#include "enums/OnionFormat.hh"
 
 extern "C"
 {
     unsigned int DecodeOnionSize(const unsigned char *onion);
 
     const unsigned char *UnsealOnion(CryptoContext *ctx, const unsigned char *onion, int &plaintextLen);
+
+    /**
+     * @brief Get the size of the header framing every layer: 2 bytes in OnionFormatV1, the version
+     * byte and 4 bytes in OnionFormatV2.
+     */
+    unsigned int GetOnionHeaderSize(OnionFormat format);
+
+    /**
+     * @brief Decode the size of the outermost layer.
+     *
+     * @param onion onion in the given format
+     * @param onionLen size of onion
+     * @param format format of onion
+     * @return unsigned int size of the layer after its header or 0 if the header is invalid or the
+     * layer does not fit in onionLen
+     */
+    unsigned int DecodeOnionLayerSize(const unsigned char *onion, unsigned int onionLen, OnionFormat format);
+
+    /**
+     * @brief Remove the outermost layer of an onion. The result starts with the address of the next
+     * hop, followed by the inner onion (or by the payload, for the last hop).
+     *
+     * @param ctx asymmetric decryption context of the hop
+     * @param onion onion in the given format
+     * @param onionLen size of onion
+     * @param format format of onion
+     * @param plaintextLen output: size of the result or -1 on error
+     * @return const unsigned char* result owned by ctx or nullptr on error
+     */
+    const unsigned char *UnsealOnionWithFormat(CryptoContext *ctx, const unsigned char *onion, unsigned int onionLen, OnionFormat format, int &plaintextLen);
 }
 
 #endif
@@ -0,0 +1,150 @@
+#ifndef ONION_ROUTE_HH
+#define ONION_ROUTE_HH
+
+#include "CryptoContext.hh"
+#include "KeyDirectory.hh"
+#include "OnionParsing.hh"
+#include "enums/OnionFormat.hh"
+
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Route of an onion, prepared once and used to seal any number of onions: it holds an
+ * encryption context, the binary address and the size overhead of every hop.
+ *
+ * Sealing is serialized per route, since the contexts keep per-operation state. Threads sealing
+ * over the same route concurrently should each use a clone, which shares the parsed keys of the
+ * route and therefore costs no key parsing.
+ */
+class OnionRoute
+{
+    struct Hop
+    {
+        CryptoContext *ctx;
+        unsigned char address[ADDRESS_SIZE];
+        unsigned int keySize;
+    };
+
+    std::vector<Hop> hops;
+    // size added by the layers and bytes in front of the payload (encrypted key, IV and address of
+    // every layer), both without the headers framing the layers, whose size depends on the format;
+    unsigned long overhead;
+    unsigned long headerSize;
+    std::mutex mutex;
+
+    OnionRoute(const OnionRoute &);
+    const OnionRoute &operator=(const OnionRoute &);
+
+    OnionRoute()
+    {
+        this->overhead = 0;
+        this->headerSize = 0;
+    }
+
+    /**
+     * @brief Append a hop; the route takes ownership of ctx, even on failure.
+     */
+    bool addHop(CryptoContext *ctx, const unsigned char *address);
+
+    unsigned long getHeaderSize(OnionFormat format) const
+    {
+        return this->headerSize + this->hops.size() * GetOnionHeaderSize(format);
+    }
+
+    /**
+     * @brief Seal the layers around a payload already at offset getHeaderSize(format) of the onion,
+     * from the innermost layer outwards, encrypting every layer in place.
+     *
+     * @param onion buffer of getOnionSize(plaintextLen, format) bytes
+     * @param plaintextLen size of the payload
+     * @param format framing of the layers
+     * @return true on success
+     */
+    bool sealLayers(unsigned char *onion, unsigned int plaintextLen, OnionFormat format);
+
+public:
+    ~OnionRoute();
+
+    unsigned int getHopCount() const { return this->hops.size(); }
+
+    const unsigned char *getAddress(unsigned int hop) const
+    {
+        return hop < this->hops.size() ? this->hops[hop].address : nullptr;
+    }
+
+    /**
+     * @brief Get the exact size of an onion sealed over the route.
+     *
+     * @return unsigned int size of the onion or 0 if it would exceed INT_MAX bytes
+     */
+    unsigned int getOnionSize(unsigned int plaintextLen, OnionFormat format = OnionFormatV1) const;
+
+    /**
+     * @brief Seal an onion; the first hop is the innermost layer, as for SealOnion.
+     *
+     * @param plaintext payload for the last hop
+     * @param plaintextLen size of plaintext
+     * @param outLen output: size of the onion or -1 on error
+     * @param format [Optional] framing of the layers; OnionFormatV1 limits every layer to 65,535 bytes
+     * @return const unsigned char* onion owned by the caller (delete[]) or nullptr on error
+     */
+    const unsigned char *seal(const unsigned char *plaintext, unsigned int plaintextLen, int &outLen, OnionFormat format = OnionFormatV1);
+
+    /**
+     * @brief Create a route over the same hops with contexts of its own, sharing the parsed keys.
+     *
+     * @return OnionRoute* pointer to newly created object or nullptr on error
+     */
+    OnionRoute *clone() const;
+
+    /**
+     * @brief Decode a hex-encoded address.
+     *
+     * @param hexAddress at least 2 * ADDRESS_SIZE hex digits
+     * @param address output buffer of ADDRESS_SIZE bytes
+     * @return true if hexAddress starts with 2 * ADDRESS_SIZE hex digits
+     */
+    static bool decodeAddress(const char *hexAddress, unsigned char *address);
+
+    class Factory
+    {
+    public:
+        /**
+         * @brief Create a route from PEM public keys and hex-encoded addresses, as given to SealOnion.
+         *
+         * @return OnionRoute* pointer to newly created object or nullptr if a key or an address is invalid
+         */
+        static OnionRoute *create(const char **keys, const char **addresses, unsigned int count);
+
+        /**
+         * @brief Create a route from parsed keys, which the route shares, and binary addresses.
+         */
+        static OnionRoute *createFromKeys(const AsymmetricKey **keys, const unsigned char **addresses, unsigned int count);
+
+        /**
+         * @brief Create a route over hex-encoded addresses whose keys are looked up in a key directory.
+         */
+        static OnionRoute *createFromKeyDirectory(KeyDirectory *directory, const char **addresses, unsigned int count);
+    };
+};
+
+extern "C"
+{
+    OnionRoute *CreateOnionRoute(const char **keys, const char **addresses, unsigned int count);
+
+    OnionRoute *CreateOnionRouteFromKeyDirectory(KeyDirectory *directory, const char **addresses, unsigned int count);
+
+    /**
+     * @brief Clone a route for use by another thread; see OnionRoute::clone.
+     */
+    OnionRoute *CloneOnionRoute(const OnionRoute *route);
+
+    void FreeOnionRoute(OnionRoute *route);
+
+    unsigned int GetOnionRouteSize(const OnionRoute *route, unsigned int plaintextLen);
+
+    unsigned int GetOnionRouteSizeWithFormat(const OnionRoute *route, unsigned int plaintextLen, OnionFormat format);
+}
+
+#endif
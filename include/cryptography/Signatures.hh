@@ -0,0 +1,90 @@
+#ifndef SIGNATURES_HH
+#define SIGNATURES_HH
+
+#include "CryptoContext.hh"
+#include "VerificationCache.hh"
+
+extern "C"
+{
+    /**
+     * @brief Sign data and return only the signature, without copying the data.
+     * The signature is owned by the context and remains valid until its next operation.
+     */
+    const unsigned char *SignDataDetached(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen, int &signatureLen);
+
+    bool VerifyDetachedSignature(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen, const unsigned char *signature, unsigned int signatureLen);
+
+    /**
+     * @brief Compute the SHA-256 digest SignDigest expects from a context using the default digest. It needs no context, so producers can
+     * hash their payloads in parallel while a single signer performs the private-key operations.
+     *
+     * @param digest output buffer of SIGNATURE_DIGEST_SIZE bytes
+     */
+    bool ComputeSignatureDigest(const unsigned char *data, unsigned int dataLen, unsigned char *digest);
+
+    bool ComputeFileSignatureDigest(const char *path, unsigned char *digest);
+
+    /**
+     * @brief Compute the digest SignDigest expects from a context using digestType.
+     *
+     * @param digest output buffer of GetSignatureDigestSize(digestType) bytes
+     */
+    bool ComputeTypedSignatureDigest(DigestType digestType, const unsigned char *data, unsigned int dataLen, unsigned char *digest);
+
+    unsigned int GetSignatureDigestSize(DigestType digestType);
+
+    /**
+     * @brief Sign a precomputed digest. The signature is the same SignDataDetached creates for the data
+     * the digest was computed from. Not available for Ed25519 contexts, as Ed25519 signs messages only.
+     */
+    const unsigned char *SignDigest(CryptoContext *ctx, const unsigned char *digest, unsigned int digestLen, int &signatureLen);
+
+    bool VerifyDigestSignature(CryptoContext *ctx, const unsigned char *digest, unsigned int digestLen, const unsigned char *signature, unsigned int signatureLen);
+
+    /**
+     * @brief Incremental signature: SignInit, then SignUpdate for every piece of data, then SignFinal.
+     * Not available for Ed25519 contexts, as Ed25519 signs the whole message at once.
+     */
+    bool SignInit(CryptoContext *ctx);
+
+    bool SignUpdate(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen);
+
+    const unsigned char *SignFinal(CryptoContext *ctx, int &signatureLen);
+
+    /**
+     * @brief Incremental verification of a detached signature: VerifyInit, then VerifyUpdate for every
+     * piece of data, then VerifyFinal. Not available for Ed25519 contexts.
+     */
+    bool VerifyInit(CryptoContext *ctx);
+
+    bool VerifyUpdate(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen);
+
+    bool VerifyFinal(CryptoContext *ctx, const unsigned char *signature, unsigned int signatureLen);
+
+    /**
+     * @brief Sign a file of any size, reading it chunk by chunk.
+     */
+    const unsigned char *SignFile(CryptoContext *ctx, const char *path, int &signatureLen);
+
+    bool VerifyFileSignature(CryptoContext *ctx, const char *path, const unsigned char *signature, unsigned int signatureLen);
+
+    /**
+     * @brief Create a cache of successful verifications holding at most capacity entries for ttlSeconds
+     * each (0 meaning no expiry). It can be shared by any number of verification contexts.
+     */
+    VerificationCache *CreateVerificationCache(unsigned int capacity, unsigned int ttlSeconds);
+
+    void FreeVerificationCache(VerificationCache *cache);
+
+    VerificationCache *GetSharedVerificationCache();
+
+    /**
+     * @brief Let a verification context skip verifying signed bytes it already verified successfully.
+     * Passing nullptr as cache disables caching. The cache must outlive the context.
+     */
+    bool SetVerificationCache(CryptoContext *ctx, VerificationCache *cache);
+
+    void GetVerificationCacheStats(VerificationCache *cache, unsigned long &hits, unsigned long &misses, unsigned int &size);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef SIGNCRYPTION_HH
+#define SIGNCRYPTION_HH
+
+#include "CryptoContext.hh"
+
+extern "C"
+{
+    /**
+     * @brief Sign plaintext and seal the signed data into an envelope in a single pass.
+     *
+     * The output has the same layout as EncryptData(encryptionCtx, SignData(signatureCtx, plaintext)),
+     * i.e. EK | IV | C(plaintext | signature) | T, so it can be opened by either OpenAndVerify or
+     * DecryptData followed by VerifySignature. The returned buffer is owned by the caller.
+     */
+    const unsigned char *SignAndSeal(CryptoContext *signatureCtx, CryptoContext *encryptionCtx, const unsigned char *plaintext, unsigned int plaintextLen, int &envelopeLen);
+
+    /**
+     * @brief Open an envelope created by SignAndSeal and verify the enclosed signature in a single pass.
+     *
+     * The plaintext is returned only if both the envelope tag and the signature are valid.
+     * The returned buffer is owned by the caller.
+     */
+    const unsigned char *OpenAndVerify(CryptoContext *decryptionCtx, CryptoContext *verificationCtx, const unsigned char *envelope, unsigned int envelopeLen, int &plaintextLen);
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define SYMMETRIC_KEY_HH
 
 #include "Key.hh"
+#include "MasterKey.hh"
 
 class SymmetricKey : public Key
 {
@@ -52,6 +53,16 @@ public:
         return false;
     }
 
+    /**
+     * @brief Derive the key from a master key, straight into the key buffer.
+     *
+     * @see MasterKey::deriveKey
+     */
+    bool deriveKeyData(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen)
+    {
+        return masterKey and this->keyData and masterKey->deriveKey(purpose, peer, peerLen, this->keyData);
+    }
+
     const void *getKeyData() const override { return this->keyData; }
 
     int getSize() const override { return this->notNullKeyData() ? SYMMETRIC_KEY_SIZE : -1; }
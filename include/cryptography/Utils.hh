@@ -1,6 +1,8 @@
 #ifndef UTILS_HH
 #define UTILS_HH
 
+#include "CryptoContext.hh"
+
 extern "C"
 {
     unsigned int GetAesGcmCiphertextSize(unsigned int plaintext);
@@ -13,9 +15,23 @@ extern "C"
 
     unsigned int GetSignedDataSize(unsigned int dataSize);
 
+    unsigned int GetEd25519SignedDataSize(unsigned int dataSize);
+
     unsigned int GetDefaultAddressSize();
 
     unsigned int GetDefaultPKeySize();
+
+    unsigned int GetContextPKeySize(const CryptoContext *ctx);
+
+    unsigned int GetContextEnvelopeSize(const CryptoContext *ctx, unsigned int plaintextLen);
+
+    unsigned int GetContextOpenEnvelopeSize(const CryptoContext *ctx, unsigned int envelopeSize);
+
+    unsigned int GetContextSignedDataSize(const CryptoContext *ctx, unsigned int dataSize);
+
+    unsigned int GetContextsOnionSize(unsigned int plaintextLen, CryptoContext **ctx, unsigned int count);
+
+    unsigned int GetOnionSize(unsigned int plaintextLen, const char **keys, unsigned int count);
 }
 
 #endif
@@ -0,0 +1,89 @@
+#ifndef VERIFICATION_CACHE_HH
+#define VERIFICATION_CACHE_HH
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#define VERIFICATION_CACHE_DIGEST_SIZE 32
+#define VERIFICATION_CACHE_DEFAULT_CAPACITY 65536
+#define VERIFICATION_CACHE_DEFAULT_TTL 300
+
+/**
+ * @brief Bounded set of digests of (public key identity, signed data, signature) tuples that have
+ * already been verified successfully. Only valid signatures are ever inserted, so a hit means the
+ * exact same bytes were verified with the exact same key before. Entries expire after a TTL and the
+ * least recently used entry is evicted when the capacity is reached. All methods are thread-safe.
+ */
+class VerificationCache
+{
+    typedef std::chrono::steady_clock Clock;
+    typedef std::list<std::string> UsageList;
+
+    struct Entry
+    {
+        Clock::time_point expires;
+        UsageList::iterator usage;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    UsageList usage;
+
+    unsigned int capacity;
+    Clock::duration ttl;
+
+    std::atomic<unsigned long> hits;
+    std::atomic<unsigned long> misses;
+    std::atomic<unsigned long> evictions;
+
+    VerificationCache(const VerificationCache &);
+    const VerificationCache &operator=(const VerificationCache &);
+
+    void erase(std::unordered_map<std::string, Entry>::iterator entry)
+    {
+        this->usage.erase(entry->second.usage);
+        this->entries.erase(entry);
+    }
+
+public:
+    /**
+     * @param capacity maximum number of entries
+     * @param ttlSeconds lifetime of an entry; 0 means entries never expire
+     */
+    VerificationCache(unsigned int capacity, unsigned int ttlSeconds);
+
+    /**
+     * @brief Look up a digest. Counts a hit or a miss; expired entries are dropped on lookup.
+     *
+     * @param digest VERIFICATION_CACHE_DIGEST_SIZE bytes
+     * @return true if the digest was verified before and has not expired
+     */
+    bool contains(const unsigned char *digest);
+
+    void insert(const unsigned char *digest);
+
+    void clear();
+
+    unsigned int getSize();
+
+    unsigned int getCapacity() const { return this->capacity; }
+
+    unsigned long getHits() const { return this->hits; }
+
+    unsigned long getMisses() const { return this->misses; }
+
+    unsigned long getEvictions() const { return this->evictions; }
+
+    /**
+     * @brief Get the process-wide cache, created on first use with default capacity and TTL.
+     *
+     * @return VerificationCache* shared cache
+     */
+    static VerificationCache *getShared();
+};
+
+#endif
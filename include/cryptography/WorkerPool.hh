@@ -0,0 +1,65 @@
+#ifndef WORKER_POOL_HH
+#define WORKER_POOL_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::mutex runMutex;
+    std::condition_variable wakeup;
+    std::condition_variable finished;
+
+    const std::function<void(unsigned int)> *task;
+    unsigned int taskCount;
+    std::atomic<unsigned int> nextTask;
+
+    unsigned long generation;
+    unsigned int activeWorkers;
+    bool stopping;
+
+    WorkerPool(const WorkerPool &);
+    const WorkerPool &operator=(const WorkerPool &);
+
+    void drain(const std::function<void(unsigned int)> *task, unsigned int taskCount);
+
+    void work();
+
+public:
+    /**
+     * @brief Create a pool of worker threads. The thread calling run() takes part in the work too,
+     * so a pool with N threads executes tasks on N + 1 threads.
+     *
+     * @param threads number of worker threads to be started
+     */
+    WorkerPool(unsigned int threads);
+
+    ~WorkerPool();
+
+    unsigned int getSize() const { return this->workers.size() + 1; }
+
+    /**
+     * @brief Execute task(0), ..., task(count - 1) on the pool and wait for all of them to complete.
+     * Calls from different threads are serialized.
+     *
+     * @param count number of tasks
+     * @param task function to be called with the index of each task
+     */
+    void run(unsigned int count, const std::function<void(unsigned int)> &task);
+
+    /**
+     * @brief Get the process-wide pool, started on first use with one thread per available core.
+     *
+     * @return WorkerPool* shared pool
+     */
+    static WorkerPool *getDefault();
+};
+
+#endif
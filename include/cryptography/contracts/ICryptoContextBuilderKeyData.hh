@@ -2,16 +2,24 @@
 #define I_CRYPTO_CONTEXT_BUILDER_KEY_DATA
 
 #include "ICryptoContextBuilder.hh"
+#include "cryptography/enums/KeyFormat.hh"
 
 class ICryptoContextBuilderKeyData
 {
 public:
     virtual ~ICryptoContextBuilderKeyData() {}
     virtual ICryptoContextBuilder *setKey256(const unsigned char *key) = 0;
+    virtual ICryptoContextBuilder *deriveKey256(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen) = 0;
     virtual ICryptoContextBuilder *setKey(const char *key) = 0;
     virtual ICryptoContextBuilder *setKey(const char *Key, const char *passphrase) = 0;
     virtual ICryptoContextBuilder *readKeyData(const char *path, const char *passphrase) = 0;
     virtual ICryptoContextBuilder *readKeyData(const char *path) = 0;
+    virtual ICryptoContextBuilder *setKey(const unsigned char *key, unsigned int keylen, KeyFormat format) = 0;
+    virtual ICryptoContextBuilder *setKey(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase) = 0;
+    virtual ICryptoContextBuilder *readKeyData(const char *path, KeyFormat format) = 0;
+    virtual ICryptoContextBuilder *readKeyData(const char *path, KeyFormat format, const char *passphrase) = 0;
+    virtual ICryptoContextBuilder *shareKey(const AsymmetricKey *key) = 0;
+    virtual ICryptoContextBuilder *bindKeyHandle(const KeyHandle *handle) = 0;
 };
 
 #endif
\ No newline at end of file
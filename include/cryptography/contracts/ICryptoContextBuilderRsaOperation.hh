@@ -3,13 +3,14 @@
 
 #include "ICryptoContextBuilderKeyData.hh"
 #include "ICryptoContextBuilderOperation.hh"
+#include "ICryptoContextBuilderSignatureOperation.hh"
+#include "cryptography/enums/DigestType.hh"
 
-class ICryptoContextBuilderRsaOperation : public ICryptoContextBuilderOperation
+class ICryptoContextBuilderRsaOperation : public ICryptoContextBuilderOperation, public ICryptoContextBuilderSignatureOperation
 {
 public:
     virtual ~ICryptoContextBuilderRsaOperation() {}
-    virtual ICryptoContextBuilderPlaintext *useSignature() = 0;
-    virtual ICryptoContextBuilderCiphertext *useSignatureVerification() = 0;
+    virtual ICryptoContextBuilderSignatureOperation *useDigest(DigestType digestType) = 0;
 };
 
 #endif
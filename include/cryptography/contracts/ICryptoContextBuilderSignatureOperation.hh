@@ -0,0 +1,15 @@
+#ifndef I_CRYPTO_CONTEXT_BUILDER_SIGNATURE_OPERATION
+#define I_CRYPTO_CONTEXT_BUILDER_SIGNATURE_OPERATION
+
+#include "ICryptoContextBuilderPlaintext.hh"
+#include "ICryptoContextBuilderCiphertext.hh"
+
+class ICryptoContextBuilderSignatureOperation
+{
+public:
+    virtual ~ICryptoContextBuilderSignatureOperation() {}
+    virtual ICryptoContextBuilderPlaintext *useSignature() = 0;
+    virtual ICryptoContextBuilderCiphertext *useSignatureVerification() = 0;
+};
+
+#endif
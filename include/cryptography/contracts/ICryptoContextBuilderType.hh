@@ -3,6 +3,7 @@
 
 #include "ICryptoContextBuilderOperation.hh"
 #include "ICryptoContextBuilderRsaOperation.hh"
+#include "ICryptoContextBuilderSignatureOperation.hh"
 
 class ICryptoContextBuilderType
 {
@@ -10,6 +11,7 @@ public:
     virtual ~ICryptoContextBuilderType() {}
     virtual ICryptoContextBuilderRsaOperation *useRsa() = 0;
     virtual ICryptoContextBuilderOperation *useAes() = 0;
+    virtual ICryptoContextBuilderSignatureOperation *useEd25519() = 0;
 };
 
 #endif
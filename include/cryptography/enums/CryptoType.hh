@@ -4,7 +4,8 @@
 enum CryptoType
 {
     SymmetricCryptography,
-    AsymmetricCryptography
+    AsymmetricCryptography,
+    Ed25519Cryptography
 };
 
 #endif
\ No newline at end of file
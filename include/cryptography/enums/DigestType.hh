@@ -0,0 +1,11 @@
+#ifndef DIGEST_TYPE_HH
+#define DIGEST_TYPE_HH
+
+enum DigestType
+{
+    Sha256Digest,
+    Sha512_256Digest,
+    Sha512Digest
+};
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef KEY_FORMAT_HH
+#define KEY_FORMAT_HH
+
+enum KeyFormat
+{
+    PemKeyFormat,
+    DerKeyFormat,
+    RawEd25519KeyFormat,
+    RawX25519KeyFormat
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef KEY_PAIR_TYPE_HH
+#define KEY_PAIR_TYPE_HH
+
+enum KeyPairType
+{
+    RsaKeyPair,
+    Ed25519KeyPair,
+    X25519KeyPair
+};
+
+#endif
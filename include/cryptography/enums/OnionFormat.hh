@@ -0,0 +1,17 @@
+#ifndef ONION_FORMAT_HH
+#define ONION_FORMAT_HH
+
+/**
+ * @brief Framing of onion layers.
+ *
+ * OnionFormatV1: every layer starts with its size as 2 big-endian bytes, limiting layers to 65,535 bytes.
+ * OnionFormatV2: every layer starts with the version byte ONION_V2_VERSION and its size as 4 big-endian
+ * bytes, so that one onion carries payloads of several megabytes.
+ */
+enum OnionFormat
+{
+    OnionFormatV1,
+    OnionFormatV2
+};
+
+#endif
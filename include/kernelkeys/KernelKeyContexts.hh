@@ -0,0 +1,47 @@
+#ifndef KERNEL_KEY_CONTEXTS_HH
+#define KERNEL_KEY_CONTEXTS_HH
+
+#include "cryptography/CryptoContext.hh"
+
+extern "C"
+{
+    /**
+     * @brief Find a key by description in a keyring. Serial numbers are cached per process, so
+     * only the first lookup of a description costs a syscall; a serial is dropped from the cache
+     * as soon as reading it fails (e.g. after the key was removed or revoked).
+     *
+     * @return serial number of the key or -1 if it cannot be found
+     */
+    int LookupKey(const char *description, int ringId);
+
+    void ClearKeyLookupCache();
+
+    /**
+     * @brief Unlock a private key once and store it, unencrypted DER, as a kernel key readable by
+     * the processes holding the keyring; contexts are then created with the *FromKernelKey factories
+     * and DerKeyFormat, without running the passphrase key derivation again. If a key with the same
+     * description is already in the keyring, it is returned as is.
+     *
+     * @return serial number of the unlocked key or -1 on failure
+     */
+    int UnlockKeyToKeyring(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase, const char *description, int ringId);
+
+    /**
+     * @brief Build contexts from the payload of a kernel key, in any KeyFormat. The payload is
+     * read into a stack buffer that is wiped right after parsing; public keys go through the
+     * parsed-key cache, which is keyed by the payload and so never serves a key that was updated.
+     */
+    CryptoContext *CreateAsymmetricEncryptionContextFromKernelKey(int keyId, KeyFormat format);
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKernelKey(int keyId, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateSignatureContextFromKernelKey(int keyId, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateVerificationContextFromKernelKey(int keyId, KeyFormat format);
+
+    CryptoContext *CreateEd25519SignatureContextFromKernelKey(int keyId, KeyFormat format, const char *passphrase = nullptr);
+
+    CryptoContext *CreateEd25519VerificationContextFromKernelKey(int keyId, KeyFormat format);
+}
+
+#endif
@@ -3,14 +3,30 @@
 
 #define MAX_KERNEL_KEY_SIZE 4096
 
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
 int CreateKey(const char *keyName, const char *keyMaterial, unsigned int keyMaterialSize, const char *tag, int ringId);
 
 int ReadKey(int keyId, char *data);
 
+/**
+ * Read the payload of a key straight into a caller buffer of the given size, without any
+ * intermediate copy; the payload is not NUL-terminated. If the buffer is too small, it is
+ * wiped and -1 is returned.
+ */
+int ReadKeyInto(int keyId, unsigned char *data, unsigned int size);
+
 int RemoveKey(int keyId);
 
 int SearchKey(const char *keyName, const char *description, int ringId);
 
 unsigned int GetKernelKeyMaxSize();
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
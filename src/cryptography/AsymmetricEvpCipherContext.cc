@@ -65,12 +65,13 @@ EncrypterResult *AsymmetricEvpCipherContext::decrypt(const EncrypterData *in)
         return this->abort();
     }
 
-    if (EVP_OpenInit(this->getCipherContext(),
+    if (not this->acquireOperationKey() or
+        EVP_OpenInit(this->getCipherContext(),
                      EVP_aes_256_gcm(),
                      this->encryptedKey,
                      this->encryptedKeyLength,
                      this->getIV(),
-                     (EVP_PKEY *)this->getKey()->getKeyData()) != 1)
+                     this->operationKey) != 1)
     {
         return this->abort();
     }
@@ -119,9 +120,10 @@ EncrypterResult *AsymmetricEvpCipherContext::encrypt(const EncrypterData *in)
         return this->abort();
     }
 
-    EVP_PKEY *pkey = (EVP_PKEY *)this->getKey()->getKeyData();
+    EVP_PKEY *pkey = this->acquireOperationKey();
 
-    if (EVP_SealInit(this->getCipherContext(),
+    if (not pkey or
+        EVP_SealInit(this->getCipherContext(),
                      EVP_aes_256_gcm(),
                      &this->encryptedKey,
                      &this->encryptedKeyLength,
@@ -157,3 +159,33 @@ EncrypterResult *AsymmetricEvpCipherContext::encrypt(const EncrypterData *in)
 
     return result;
 }
+
+bool AsymmetricEvpCipherContext::sealInPlace(unsigned char *envelope, unsigned int plaintextLen)
+{
+    int N = this->getKeySize();
+
+    // the cipher context is kept between envelopes, EVP_SealInit resets it;
+    if (not envelope or N <= 0 or (not this->getCipherContext() and not this->allocateCipherContext()))
+    {
+        return false;
+    }
+
+    EVP_PKEY *pkey = static_cast<const AsymmetricKey *>(this->getKey())->acquire();
+    unsigned char *encryptedKey = envelope;
+    unsigned char *iv = envelope + N;
+    unsigned char *data = iv + IV_SIZE;
+    int encryptedKeyLength;
+    int len;
+    int len2;
+
+    bool ok = pkey and
+              EVP_SealInit(this->getCipherContext(), EVP_aes_256_gcm(), &encryptedKey, &encryptedKeyLength, iv, &pkey, 1) == 1 and
+              encryptedKeyLength == N and
+              EVP_SealUpdate(this->getCipherContext(), data, &len, data, plaintextLen) == 1 and
+              EVP_SealFinal(this->getCipherContext(), data + len, &len2) == 1 and
+              EVP_CIPHER_CTX_ctrl(this->getCipherContext(), EVP_CTRL_GCM_GET_TAG, TAG_SIZE, data + plaintextLen) == 1;
+
+    EVP_PKEY_free(pkey);
+
+    return ok;
+}
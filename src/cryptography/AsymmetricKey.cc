@@ -1,8 +1,18 @@
 #include "cryptography/AsymmetricKey.hh"
+#include "cryptography/KeyCache.hh"
+#include "cryptography/KeyHandle.hh"
+#include "cryptography/MappedFile.hh"
 
+#include <climits>
 #include <cstring>
 #include <openssl/bio.h>
 #include <openssl/pem.h>
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+#include <utility>
+
+#define RAW_PUBLIC_KEY_SIZE 32
+#define RAW_PUBLIC_KEY_DER_SIZE 44
 
 static char *AllocatePassphraseBuffer(const char *passphrase)
 {
@@ -19,70 +29,447 @@ static char *AllocatePassphraseBuffer(const char *passphrase)
     return newBuffer;
 }
 
-bool AsymmetricKey::setKeyData(const unsigned char *keyData, unsigned int len, const char *passphrase)
+static EVP_PKEY *ReadPemKey(KeyType keyType, const unsigned char *keyData, unsigned int len, const char *passphrase)
 {
-    this->freeKey();
+    BIO *bio = BIO_new_mem_buf((const char *)keyData, len);
+
+    if (not bio)
+    {
+        return nullptr;
+    }
+
+    char *p = AllocatePassphraseBuffer(passphrase);
+    EVP_PKEY *key = keyType == PublicKey ? PEM_read_bio_PUBKEY(bio, nullptr, nullptr, p)
+                                         : PEM_read_bio_PrivateKey(bio, nullptr, nullptr, p);
+
+    BIO_free(bio);
+    delete[] p;
+
+    return key;
+}
+
+static EVP_PKEY *ReadDerKey(KeyType keyType, const unsigned char *keyData, unsigned int len, const char *passphrase)
+{
+    const unsigned char *in = keyData;
+
+    if (keyType == PublicKey)
+    {
+        return d2i_PUBKEY(nullptr, &in, len);
+    }
+
+    EVP_PKEY *key = d2i_AutoPrivateKey(nullptr, &in, len);
 
+    if (key or not passphrase)
+    {
+        return key;
+    }
+
+    // an encrypted PKCS#8 structure is only recognized by the PKCS#8 reader;
     BIO *bio = BIO_new_mem_buf((const char *)keyData, len);
 
     if (not bio)
+    {
+        return nullptr;
+    }
+
+    char *p = AllocatePassphraseBuffer(passphrase);
+    key = d2i_PKCS8PrivateKey_bio(bio, nullptr, nullptr, p);
+
+    BIO_free(bio);
+    delete[] p;
+
+    return key;
+}
+
+static EVP_PKEY *ReadRawKey(KeyType keyType, int type, const unsigned char *keyData, unsigned int len)
+{
+    return keyType == PublicKey ? EVP_PKEY_new_raw_public_key(type, nullptr, keyData, len)
+                                : EVP_PKEY_new_raw_private_key(type, nullptr, keyData, len);
+}
+
+bool AsymmetricKey::setKeyData(const unsigned char *keyData, unsigned int len, const char *passphrase)
+{
+    return this->setKeyData(keyData, len, PemKeyFormat, passphrase);
+}
+
+bool AsymmetricKey::setKeyData(const unsigned char *keyData, unsigned int len, KeyFormat format, const char *passphrase)
+{
+    this->freeKey();
+
+    if (not keyData or not(this->isPublicKey() or this->isPrivateKey()))
     {
         return false;
     }
 
-    char *p = nullptr;
+    // public keys are shared through the key cache; private keys only when the unlocked key cache
+    // has been enabled, so that by default no unlocked private key outlives the contexts using it;
+    // raw keys are cheaper to build than to look up;
+    KeyCache *cache = this->isPublicKey() ? KeyCache::getInstance() : KeyCache::getUnlockedInstance();
+    unsigned char digest[KEY_CACHE_DIGEST_SIZE];
+    bool cacheable = cache->getCapacity() > 0 and (format == PemKeyFormat or format == DerKeyFormat) and
+                     KeyCache::computeDigest(keyData, len, format, this->isPrivateKey() ? passphrase : nullptr, digest);
 
-    switch (this->getKeyType())
+    if (cacheable and (this->key = cache->get(digest)))
     {
-    case PublicKey:
-        p = AllocatePassphraseBuffer(passphrase);
-        this->key = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, p);
+        return true;
+    }
+
+    switch (format)
+    {
+    case PemKeyFormat:
+        this->key = ReadPemKey(this->getKeyType(), keyData, len, passphrase);
+        break;
+    case DerKeyFormat:
+        this->key = ReadDerKey(this->getKeyType(), keyData, len, passphrase);
+        break;
+    case RawEd25519KeyFormat:
+        this->key = ReadRawKey(this->getKeyType(), EVP_PKEY_ED25519, keyData, len);
         break;
-    case PrivateKey:
-        p = AllocatePassphraseBuffer(passphrase);
-        this->key = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, p);
+    case RawX25519KeyFormat:
+        this->key = ReadRawKey(this->getKeyType(), EVP_PKEY_X25519, keyData, len);
         break;
     default:
-        BIO_free(bio);
         return false;
     }
 
-    BIO_free(bio);
-    delete[] p;
+    if (cacheable and this->notNullKeyData())
+    {
+        cache->put(digest, this->key);
+    }
 
     return this->notNullKeyData();
 }
 
 bool AsymmetricKey::readKeyFile(const char *path, const char *passphrase)
+{
+    return this->readKeyFile(path, PemKeyFormat, passphrase);
+}
+
+bool AsymmetricKey::readKeyFile(const char *path, KeyFormat format, const char *passphrase)
 {
     this->freeKey();
 
-    FILE *keyFile = fopen(path, "r");
+    // the key is parsed straight from the page cache: no stdio buffering and no copy;
+    MappedFile *file = MappedFile::Factory::create(path);
 
-    if (not keyFile)
+    if (not file or file->getSize() > UINT_MAX)
     {
+        delete file;
         return false;
     }
 
-    char *p = nullptr;
+    bool ok = this->setKeyData(file->getData(), file->getSize(), format, passphrase);
+    delete file;
+
+    return ok;
+}
+
+bool AsymmetricKey::generate(KeyPairType type, unsigned int bits)
+{
+    this->freeKey();
+
+    if (not this->isPrivateKey())
+    {
+        return false;
+    }
 
-    switch (this->getKeyType())
+    switch (type)
     {
-    case PublicKey:
-        p = AllocatePassphraseBuffer(passphrase);
-        this->key = PEM_read_PUBKEY(keyFile, nullptr, nullptr, p);
+    case RsaKeyPair:
+        this->key = EVP_PKEY_Q_keygen(nullptr, nullptr, "RSA", (size_t)bits);
+        break;
+    case Ed25519KeyPair:
+        this->key = EVP_PKEY_Q_keygen(nullptr, nullptr, "ED25519");
         break;
-    case PrivateKey:
-        p = AllocatePassphraseBuffer(passphrase);
-        this->key = PEM_read_PrivateKey(keyFile, nullptr, nullptr, p);
+    case X25519KeyPair:
+        this->key = EVP_PKEY_Q_keygen(nullptr, nullptr, "X25519");
         break;
     default:
-        fclose(keyFile);
         return false;
     }
 
-    fclose(keyFile);
+    return this->notNullKeyData();
+}
+
+static unsigned char *CopyBio(BIO *bio, bool written, unsigned int &len)
+{
+    char *data = nullptr;
+    long size = written ? BIO_get_mem_data(bio, &data) : 0;
+    unsigned char *out = nullptr;
+
+    if (size > 0)
+    {
+        out = new unsigned char[size];
+        memcpy(out, data, size);
+        len = size;
+    }
+
+    // the memory BIO may hold a private key;
+    if (data)
+    {
+        OPENSSL_cleanse(data, size);
+    }
+
+    BIO_free(bio);
+
+    return out;
+}
+
+static unsigned char *ExportRawKey(const EVP_PKEY *key, KeyFormat format, bool privateKey, unsigned int &len)
+{
+    int type = format == RawEd25519KeyFormat ? EVP_PKEY_ED25519 : EVP_PKEY_X25519;
+    size_t size = 0;
+
+    if (EVP_PKEY_get_base_id(key) != type or
+        (privateKey ? EVP_PKEY_get_raw_private_key(key, nullptr, &size) : EVP_PKEY_get_raw_public_key(key, nullptr, &size)) != 1)
+    {
+        return nullptr;
+    }
+
+    unsigned char *out = new unsigned char[size];
+
+    if ((privateKey ? EVP_PKEY_get_raw_private_key(key, out, &size) : EVP_PKEY_get_raw_public_key(key, out, &size)) != 1)
+    {
+        delete[] out;
+        return nullptr;
+    }
+
+    len = size;
+
+    return out;
+}
+
+static unsigned char *ExportPrivateKey(const EVP_PKEY *key, KeyFormat format, const char *passphrase, unsigned int &len)
+{
+    if (format == RawEd25519KeyFormat or format == RawX25519KeyFormat)
+    {
+        return ExportRawKey(key, format, true, len);
+    }
+
+    BIO *bio = BIO_new(BIO_s_mem());
+
+    if (not bio)
+    {
+        return nullptr;
+    }
+
+    const EVP_CIPHER *cipher = passphrase ? EVP_aes_256_cbc() : nullptr;
+    char *p = AllocatePassphraseBuffer(passphrase);
+    int plen = p ? strlen(p) : 0;
+
+    bool written = format == PemKeyFormat ? PEM_write_bio_PKCS8PrivateKey(bio, key, cipher, p, plen, nullptr, nullptr) == 1
+                                          : format == DerKeyFormat and i2d_PKCS8PrivateKey_bio(bio, key, cipher, p, plen, nullptr, nullptr) == 1;
+
     delete[] p;
 
+    return CopyBio(bio, written, len);
+}
+
+static unsigned char *ExportPublicKey(const EVP_PKEY *key, KeyFormat format, unsigned int &len)
+{
+    if (format == RawEd25519KeyFormat or format == RawX25519KeyFormat)
+    {
+        return ExportRawKey(key, format, false, len);
+    }
+
+    BIO *bio = BIO_new(BIO_s_mem());
+
+    if (not bio)
+    {
+        return nullptr;
+    }
+
+    bool written = format == PemKeyFormat ? PEM_write_bio_PUBKEY(bio, key) == 1
+                                          : format == DerKeyFormat and i2d_PUBKEY_bio(bio, key) == 1;
+
+    return CopyBio(bio, written, len);
+}
+
+unsigned char *AsymmetricKey::exportKey(KeyFormat format, unsigned int &len, const char *passphrase) const
+{
+    if (not this->isPrivateKey())
+    {
+        return this->exportPublicKey(format, len);
+    }
+
+    len = 0;
+
+    EVP_PKEY *pkey = this->acquire();
+    unsigned char *out = pkey ? ExportPrivateKey(pkey, format, passphrase, len) : nullptr;
+
+    EVP_PKEY_free(pkey);
+
+    return out;
+}
+
+unsigned char *AsymmetricKey::exportPublicKey(KeyFormat format, unsigned int &len) const
+{
+    len = 0;
+
+    EVP_PKEY *pkey = this->acquire();
+    unsigned char *out = pkey ? ExportPublicKey(pkey, format, len) : nullptr;
+
+    EVP_PKEY_free(pkey);
+
+    return out;
+}
+
+static int EncodeRawPublicKey(const EVP_PKEY *pkey, unsigned char *der)
+{
+    // SubjectPublicKeyInfo of a 32-byte key, up to the last byte of the algorithm OID;
+    static const unsigned char prefix[] = {0x30, 0x2a, 0x30, 0x05, 0x06, 0x03, 0x2b, 0x65, 0x00, 0x03, 0x21, 0x00};
+    static const unsigned int oidEnd = 8;
+
+    int type = EVP_PKEY_get_base_id(pkey);
+    size_t len = RAW_PUBLIC_KEY_SIZE;
+
+    if ((type != EVP_PKEY_ED25519 and type != EVP_PKEY_X25519) or
+        EVP_PKEY_get_raw_public_key(pkey, der + sizeof(prefix), &len) != 1 or len != RAW_PUBLIC_KEY_SIZE)
+    {
+        return 0;
+    }
+
+    memcpy(der, prefix, sizeof(prefix));
+    der[oidEnd] = type == EVP_PKEY_ED25519 ? 0x70 : 0x6e;
+
+    return sizeof(prefix) + len;
+}
+
+bool AsymmetricKey::getAddress(unsigned char *address) const
+{
+    if (not address)
+    {
+        return false;
+    }
+
+    EVP_PKEY *pkey = this->acquire();
+
+    if (not pkey)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->addressMutex);
+
+    if (this->addressKey != pkey)
+    {
+        // X25519 and Ed25519 keys are encoded directly, which is much cheaper than the generic encoder;
+        unsigned char rawDer[RAW_PUBLIC_KEY_DER_SIZE];
+        int len = EncodeRawPublicKey(pkey, rawDer);
+        bool hashed = len > 0 and SHA256(rawDer, len, this->address) != nullptr;
+
+        if (not len)
+        {
+            unsigned char *der = nullptr;
+
+            len = i2d_PUBKEY(pkey, &der);
+            hashed = len > 0 and SHA256(der, len, this->address) != nullptr;
+
+            OPENSSL_free(der);
+        }
+
+        if (not hashed)
+        {
+            // the cached address was overwritten;
+            EVP_PKEY_free(this->addressKey);
+            EVP_PKEY_free(pkey);
+            this->addressKey = nullptr;
+            return false;
+        }
+
+        // the cache keeps the reference taken above;
+        std::swap(this->addressKey, pkey);
+    }
+
+    EVP_PKEY_free(pkey);
+    memcpy(address, this->address, ADDRESS_SIZE);
+
+    return true;
+}
+
+bool AsymmetricKey::bindHandle(const KeyHandle *handle)
+{
+    this->freeKey();
+
+    if (not handle or handle->getKeyType() != this->getKeyType())
+    {
+        return false;
+    }
+
+    unsigned long version;
+
+    this->key = handle->acquire(version);
+    this->handleVersion = version;
+    this->handle = this->key ? handle : nullptr;
+
+    return this->notNullKeyData();
+}
+
+void AsymmetricKey::followHandle() const
+{
+    if (this->handle->getVersion() == this->handleVersion)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->handleMutex);
+
+    // another thread may have followed the rotation while this one waited;
+    if (this->handle->getVersion() == this->handleVersion)
+    {
+        return;
+    }
+
+    unsigned long version;
+    EVP_PKEY *pkey = this->handle->acquire(version);
+
+    if (pkey)
+    {
+        // operations still running on the previous key hold their own reference to it;
+        EVP_PKEY_free(this->key.exchange(pkey));
+        this->handleVersion = version;
+    }
+}
+
+EVP_PKEY *AsymmetricKey::acquire() const
+{
+    if (this->handle)
+    {
+        unsigned long version;
+
+        return this->handle->acquire(version);
+    }
+
+    EVP_PKEY *pkey = this->key;
+
+    return pkey and EVP_PKEY_up_ref(pkey) == 1 ? pkey : nullptr;
+}
+
+int AsymmetricKey::getSize() const
+{
+    EVP_PKEY *pkey = this->acquire();
+    int size = pkey ? EVP_PKEY_size(pkey) : -1;
+
+    EVP_PKEY_free(pkey);
+
+    return size;
+}
+
+bool AsymmetricKey::shareKey(const AsymmetricKey *other)
+{
+    this->freeKey();
+
+    if (not other or other->getKeyType() != this->getKeyType())
+    {
+        return false;
+    }
+
+    if (other->handle)
+    {
+        return this->bindHandle(other->handle);
+    }
+
+    this->key = other->acquire();
+
     return this->notNullKeyData();
 }
@@ -0,0 +1,138 @@
+#include "cryptography/BatchVerification.hh"
+#include "cryptography/EvpMdContext.hh"
+#include "cryptography/WorkerPool.hh"
+
+#include <cstring>
+#include <vector>
+
+// items are verified in blocks of eight, so each bitmap byte is written by exactly one task;
+#define ITEMS_PER_TASK 8
+
+class ThreadMdContext
+{
+    EVP_MD_CTX *mdContext;
+
+public:
+    ThreadMdContext() { this->mdContext = EVP_MD_CTX_new(); }
+
+    ~ThreadMdContext() { EVP_MD_CTX_free(this->mdContext); }
+
+    EVP_MD_CTX *get() const { return this->mdContext; }
+};
+
+static EVP_MD_CTX *GetThreadMdContext()
+{
+    static thread_local ThreadMdContext mdContext;
+
+    return mdContext.get();
+}
+
+struct VerificationKey
+{
+    EVP_PKEY *pkey;
+    const EVP_MD *md;
+};
+
+static bool GetVerificationKey(CryptoContext *ctx, VerificationKey &key)
+{
+    EvpMdContext *cipher = ctx and ctx->isSetForVerifying() ? ctx->getSignatureCipher() : nullptr;
+
+    if (not cipher)
+    {
+        return false;
+    }
+
+    // workers use their own reference, since a context listed twice may rebind another key;
+    key.pkey = cipher->getSuitableKey();
+    key.md = cipher->getDigest();
+
+    if (key.pkey and EVP_PKEY_up_ref(key.pkey) != 1)
+    {
+        key.pkey = nullptr;
+    }
+
+    return key.pkey != nullptr;
+}
+
+static void FreeVerificationKeys(std::vector<VerificationKey> &keys)
+{
+    for (VerificationKey &key : keys)
+    {
+        EVP_PKEY_free(key.pkey);
+        key.pkey = nullptr;
+    }
+}
+
+static unsigned char VerifyBlock(const std::vector<VerificationKey> &keys, const unsigned char **signedData, const unsigned int *signedDataLen,
+                                 unsigned int first, unsigned int last)
+{
+    EVP_MD_CTX *mdContext = GetThreadMdContext();
+    unsigned char bits = 0;
+
+    for (unsigned int i = first; i < last; i++)
+    {
+        const VerificationKey &key = keys.size() == 1 ? keys[0] : keys[i];
+
+        if (EvpMdContext::verifySignedData(mdContext, key.pkey, key.md, signedData[i], signedDataLen[i]))
+        {
+            bits |= 1 << (i - first);
+        }
+    }
+
+    return bits;
+}
+
+extern "C"
+{
+    unsigned int GetVerificationBitmapSize(unsigned int count)
+    {
+        return (count + 7) / 8;
+    }
+
+    bool IsVerified(const unsigned char *bitmap, unsigned int index)
+    {
+        return bitmap and (bitmap[index / 8] >> (index % 8)) & 1;
+    }
+
+    bool VerifySignaturesParallel(CryptoContext **ctx, unsigned int ctxCount, const unsigned char **signedData, const unsigned int *signedDataLen, unsigned int count, unsigned char *bitmap)
+    {
+        if (not ctx or not signedData or not signedDataLen or not bitmap or (ctxCount != 1 and ctxCount != count))
+        {
+            return false;
+        }
+
+        unsigned int bitmapSize = GetVerificationBitmapSize(count);
+        memset(bitmap, 0, bitmapSize);
+
+        // keys are resolved once on the calling thread; workers only read them;
+        std::vector<VerificationKey> keys(ctxCount, VerificationKey{nullptr, nullptr});
+
+        for (unsigned int i = 0; i < ctxCount; i++)
+        {
+            if (not GetVerificationKey(ctx[i], keys[i]))
+            {
+                FreeVerificationKeys(keys);
+                return false;
+            }
+        }
+
+        WorkerPool::getDefault()->run(bitmapSize, [&](unsigned int task)
+                                      {
+            unsigned int first = task * ITEMS_PER_TASK;
+            unsigned int last = first + ITEMS_PER_TASK < count ? first + ITEMS_PER_TASK : count;
+
+            bitmap[task] = VerifyBlock(keys, signedData, signedDataLen, first, last); });
+
+        FreeVerificationKeys(keys);
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (not IsVerified(bitmap, i))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -25,6 +25,19 @@ bool CryptoContext::allocateKey()
             return false;
         }
         break;
+    case Ed25519Cryptography:
+        switch (this->getCryptoOp())
+        {
+        case SignVerify:
+            this->key = AsymmetricKey::Factory::createPublicKey();
+            break;
+        case Sign:
+            this->key = AsymmetricKey::Factory::createPrivateKey();
+            break;
+        default:
+            return false;
+        }
+        break;
     default:
         return false;
     }
@@ -53,7 +66,19 @@ bool CryptoContext::allocateCipher()
             break;
         case Sign:
         case SignVerify:
-            this->cipher = EvpMdContext::Factory::create(this->key);
+            this->cipher = EvpMdContext::Factory::create(this->key, this->getDigestType());
+            break;
+        default:
+            return false;
+        }
+
+        break;
+    case Ed25519Cryptography:
+        switch (this->getCryptoOp())
+        {
+        case Sign:
+        case SignVerify:
+            this->cipher = EvpMdContext::Factory::createEd25519(this->key);
             break;
         default:
             return false;
@@ -90,3 +115,59 @@ bool CryptoContext::allocateCryptoMachine()
 
     return this->notNullCryptoMachine();
 }
+
+bool CryptoContext::verifyBatch(const unsigned char **data, const unsigned int *datalen, unsigned int count, bool *results)
+{
+    if (not this->isSetForVerifying() or not this->notNullCipher())
+    {
+        return false;
+    }
+
+    return static_cast<EvpMdContext *>(this->cipher)->verifyBatch(data, datalen, count, results);
+}
+
+bool CryptoContext::sealEnvelopeInPlace(unsigned char *envelope, unsigned int plaintextLen)
+{
+    if (not this->isSetForEncryption() or this->getCryptoType() != AsymmetricCryptography or not this->notNullCipher())
+    {
+        return false;
+    }
+
+    return static_cast<AsymmetricEvpCipherContext *>(this->cipher)->sealInPlace(envelope, plaintextLen);
+}
+
+EvpMdContext *CryptoContext::getSignatureCipher() const
+{
+    if (not(this->isSetForSigning() or this->isSetForVerifying()) or not this->notNullCipher())
+    {
+        return nullptr;
+    }
+
+    return static_cast<EvpMdContext *>(this->cipher);
+}
+
+bool CryptoContext::setVerificationCache(VerificationCache *cache)
+{
+    EvpMdContext *cipher = this->isSetForVerifying() ? this->getSignatureCipher() : nullptr;
+
+    if (not cipher)
+    {
+        return false;
+    }
+
+    cipher->setVerificationCache(cache);
+
+    return true;
+}
+
+void CryptoContext::setDigestType(DigestType digestType)
+{
+    this->digestType = digestType;
+
+    EvpMdContext *cipher = this->getSignatureCipher();
+
+    if (cipher)
+    {
+        cipher->setDigest(digestType);
+    }
+}
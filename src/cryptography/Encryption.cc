@@ -72,4 +72,9 @@ extern "C"
 
         return plaintext != nullptr and not plaintext->isError();
     }
+
+    bool VerifySignatures(CryptoContext *ctx, const unsigned char **ciphertexts, const unsigned int *cipherLens, unsigned int count, bool *results)
+    {
+        return ctx and ctx->verifyBatch(ciphertexts, cipherLens, count, results);
+    }
 }
@@ -1,5 +1,7 @@
 #include "cryptography/EvpMdContext.hh"
 
+#include <openssl/x509.h>
+
 EncrypterResult *EvpMdContext::createSignedData(const EncrypterData *in) const
 {
     unsigned int signedDataSize = in->getDataSize() + this->getOutBufferSize();
@@ -15,70 +17,258 @@ EncrypterResult *EvpMdContext::createSignedData(const EncrypterData *in) const
     return result;
 }
 
-const unsigned char *EvpMdContext::readSignedData(const EncrypterData *in, int &datasize)
+bool EvpMdContext::verifySignedData(EVP_MD_CTX *mdContext, EVP_PKEY *pkey, const EVP_MD *md, const unsigned char *in, unsigned int inlen)
 {
-    datasize = -1;
+    if (not pkey or not in)
+    {
+        return false;
+    }
 
-    if (not in or not in->getData())
+    int pkeySize = EVP_PKEY_size(pkey);
+
+    if (pkeySize <= 0 or inlen < (unsigned int)pkeySize)
     {
-        return nullptr;
+        return false;
+    }
+
+    unsigned int datalen = inlen - pkeySize;
+
+    return verifySignature(mdContext, pkey, md, in, datalen, in + datalen, pkeySize);
+}
+
+bool EvpMdContext::verifySignature(EVP_MD_CTX *mdContext, EVP_PKEY *pkey, const EVP_MD *md, const unsigned char *in, unsigned int inlen,
+                                   const unsigned char *sig, unsigned int siglen)
+{
+    if (not mdContext or not pkey or not in or not sig)
+    {
+        return false;
     }
 
-    unsigned int pkeySize = this->getKeySize();
+    return EVP_MD_CTX_reset(mdContext) == 1 and
+           EVP_DigestVerifyInit(mdContext, nullptr, md, nullptr, pkey) == 1 and
+           EVP_DigestVerify(mdContext, sig, siglen, in, inlen) == 1;
+}
 
-    if (not this->writeInSig(in->getData() + in->getDataSize() - pkeySize, pkeySize))
+bool EvpMdContext::bindKey(EVP_PKEY *pkey)
+{
+    if (this->templateKey == pkey)
+    {
+        return true;
+    }
+
+    this->freeTemplates();
+
+    unsigned char *der = nullptr;
+    int derlen = i2d_PUBKEY(pkey, &der);
+    unsigned int identitySize;
+
+    bool ok = derlen > 0 and
+              EVP_Digest(der, derlen, this->keyIdentity, &identitySize, EVP_sha256(), nullptr) == 1 and
+              EVP_PKEY_up_ref(pkey) == 1;
+
+    OPENSSL_free(der);
+
+    if (ok)
+    {
+        this->templateKey = pkey;
+    }
+
+    return ok;
+}
+
+bool EvpMdContext::createCacheDigest(const unsigned char *in, unsigned int inlen, const unsigned char *sig, unsigned int siglen, unsigned char *digest)
+{
+    EVP_PKEY *pkey = this->getSuitableKey();
+
+    if (not pkey or not this->bindKey(pkey))
+    {
+        return false;
+    }
+
+    if (not this->hashContext and not(this->hashContext = EVP_MD_CTX_new()))
+    {
+        return false;
+    }
+
+    unsigned int digestSize;
+    // the lengths are hashed ahead of the data, so bytes cannot move between data and signature;
+    unsigned char lengths[] = {(unsigned char)(inlen >> 24), (unsigned char)(inlen >> 16),
+                               (unsigned char)(inlen >> 8), (unsigned char)inlen,
+                               (unsigned char)(siglen >> 24), (unsigned char)(siglen >> 16),
+                               (unsigned char)(siglen >> 8), (unsigned char)siglen};
+
+    return EVP_DigestInit_ex(this->hashContext, EVP_sha256(), nullptr) == 1 and
+           EVP_DigestUpdate(this->hashContext, this->keyIdentity, VERIFICATION_CACHE_DIGEST_SIZE) == 1 and
+           EVP_DigestUpdate(this->hashContext, lengths, sizeof(lengths)) == 1 and
+           EVP_DigestUpdate(this->hashContext, in, inlen) == 1 and
+           EVP_DigestUpdate(this->hashContext, sig, siglen) == 1 and
+           EVP_DigestFinal_ex(this->hashContext, digest, &digestSize) == 1;
+}
+
+EVP_MD_CTX *EvpMdContext::getTemplate(bool signing, EVP_PKEY *pkey)
+{
+    if (not this->bindKey(pkey))
     {
         return nullptr;
     }
 
-    datasize = in->getDataSize() - pkeySize;
+    EVP_MD_CTX *&mdTemplate = signing ? this->signTemplate : this->verifyTemplate;
 
-    return in->getData();
+    if (mdTemplate)
+    {
+        return mdTemplate;
+    }
+
+    mdTemplate = EVP_MD_CTX_new();
+
+    bool ok = mdTemplate and
+              (signing ? EVP_DigestSignInit(mdTemplate, nullptr, this->getDigest(), nullptr, pkey)
+                       : EVP_DigestVerifyInit(mdTemplate, nullptr, this->getDigest(), nullptr, pkey)) == 1;
+
+    if (not ok)
+    {
+        EVP_MD_CTX_free(mdTemplate);
+        mdTemplate = nullptr;
+    }
+
+    return mdTemplate;
 }
 
-EncrypterResult *EvpMdContext::encrypt(const EncrypterData *in)
+EVP_PKEY_CTX *EvpMdContext::getDigestContext(bool signing)
 {
-    if (not in or not in->getData())
+    EVP_PKEY *pkey = this->getSuitableKey();
+
+    if (not pkey or this->isEd25519() or not this->bindKey(pkey))
     {
-        return this->abort();
+        return nullptr;
     }
 
-    this->cleanup();
+    EVP_PKEY_CTX *&pkeyContext = signing ? this->digestSignContext : this->digestVerifyContext;
 
-    if (not this->allocateMdContext())
+    if (pkeyContext)
     {
-        return this->abort();
+        return pkeyContext;
     }
 
-    if (EVP_DigestSignInit(this->mdContext, nullptr, EVP_sha256(), nullptr, (EVP_PKEY *)this->getKey()->getKeyData()) != 1)
+    pkeyContext = EVP_PKEY_CTX_new(pkey, nullptr);
+
+    bool ok = pkeyContext and
+              (signing ? EVP_PKEY_sign_init(pkeyContext) : EVP_PKEY_verify_init(pkeyContext)) == 1 and
+              EVP_PKEY_CTX_set_signature_md(pkeyContext, this->getDigest()) == 1;
+
+    if (not ok)
     {
-        return this->abort();
+        EVP_PKEY_CTX_free(pkeyContext);
+        pkeyContext = nullptr;
     }
 
-    if (EVP_DigestSignUpdate(this->mdContext, in->getData(), in->getDataSize()) != 1)
+    return pkeyContext;
+}
+
+const EVP_MD *EvpMdContext::detectDigest(EVP_PKEY *pkey, const unsigned char *sig, unsigned int siglen) const
+{
+    if (this->isEd25519() or EVP_PKEY_get_base_id(pkey) != EVP_PKEY_RSA)
     {
-        return this->abort();
+        return nullptr;
+    }
+
+    EVP_PKEY_CTX *pkeyContext = EVP_PKEY_CTX_new(pkey, nullptr);
+    unsigned char *digestInfo = new unsigned char[EVP_PKEY_size(pkey) + 1];
+    size_t digestInfoLen = EVP_PKEY_size(pkey);
+    const EVP_MD *detected = nullptr;
+
+    // without a signature digest, PKCS#1 v1.5 recovery returns the DER encoded DigestInfo itself;
+    if (pkeyContext and EVP_PKEY_verify_recover_init(pkeyContext) == 1 and
+        EVP_PKEY_verify_recover(pkeyContext, digestInfo, &digestInfoLen, sig, siglen) == 1)
+    {
+        const unsigned char *p = digestInfo;
+        X509_SIG *info = d2i_X509_SIG(nullptr, &p, digestInfoLen);
+
+        if (info)
+        {
+            const X509_ALGOR *algorithm;
+            X509_SIG_get0(info, &algorithm, nullptr);
+
+            const ASN1_OBJECT *object;
+            X509_ALGOR_get0(&object, nullptr, nullptr, algorithm);
+
+            switch (OBJ_obj2nid(object))
+            {
+            case NID_sha256:
+                detected = getDigestByType(Sha256Digest);
+                break;
+            case NID_sha512_256:
+                detected = getDigestByType(Sha512_256Digest);
+                break;
+            case NID_sha512:
+                detected = getDigestByType(Sha512Digest);
+                break;
+            default:
+                break;
+            }
+
+            X509_SIG_free(info);
+        }
+    }
+
+    delete[] digestInfo;
+    EVP_PKEY_CTX_free(pkeyContext);
+
+    return detected != this->digest ? detected : nullptr;
+}
+
+bool EvpMdContext::startOperation(bool signing)
+{
+    EVP_PKEY *pkey = this->getSuitableKey();
+    EVP_MD_CTX *mdTemplate = pkey ? this->getTemplate(signing, pkey) : nullptr;
+
+    return mdTemplate and this->initMdContext() and EVP_MD_CTX_copy_ex(this->mdContext, mdTemplate) == 1;
+}
+
+bool EvpMdContext::createSignature(const unsigned char *in, unsigned int inlen)
+{
+    if (not this->startOperation(true))
+    {
+        return false;
     }
 
     size_t siglen;
 
-    if (EVP_DigestSignFinal(this->mdContext, nullptr, &siglen) != 1)
+    if (EVP_DigestSign(this->mdContext, nullptr, &siglen, in, inlen) != 1)
     {
-        return this->abort();
+        return false;
     }
 
-    if (not this->allocateOutBuffer(siglen))
+    if (not this->reserveOutBuffer(siglen))
     {
-        return this->abort();
+        return false;
     }
 
-    if (EVP_DigestSignFinal(this->mdContext, this->getOutBuffer(), &siglen) != 1)
+    // one-shot signing is required by Ed25519 and is equivalent to update + final for RSA;
+    if (EVP_DigestSign(this->mdContext, this->getOutBuffer(), &siglen, in, inlen) != 1)
     {
-        return this->abort();
+        return false;
     }
 
     this->setOutBufferSize(siglen);
 
+    return true;
+}
+
+EncrypterResult *EvpMdContext::encrypt(const EncrypterData *in)
+{
+    if (not in or not in->getData())
+    {
+        return this->abort();
+    }
+
+    this->cleanup();
+
+    if (not this->createSignature(in->getData(), in->getDataSize()))
+    {
+        return this->abort();
+    }
+
     EncrypterResult *result = this->createSignedData(in);
 
     this->cleanup();
@@ -86,6 +276,43 @@ EncrypterResult *EvpMdContext::encrypt(const EncrypterData *in)
     return result;
 }
 
+bool EvpMdContext::verify(const unsigned char *in, unsigned int inlen)
+{
+    EVP_PKEY *pkey = this->getSuitableKey();
+    int siglen = pkey ? EVP_PKEY_size(pkey) : 0;
+
+    return siglen > 0 and in and inlen >= (unsigned int)siglen and
+           this->verifyDetached(in, inlen - siglen, in + inlen - siglen, siglen);
+}
+
+bool EvpMdContext::verifyBatch(const unsigned char **in, const unsigned int *inlen, unsigned int count, bool *results)
+{
+    if (not in or not inlen)
+    {
+        return false;
+    }
+
+    this->cleanup();
+
+    bool ok = true;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        bool valid = this->verify(in[i], inlen[i]);
+
+        if (results)
+        {
+            results[i] = valid;
+        }
+
+        ok = ok and valid;
+    }
+
+    this->cleanup();
+
+    return ok;
+}
+
 EncrypterResult *EvpMdContext::decrypt(const EncrypterData *in)
 {
     if (not in or not in->getData())
@@ -95,33 +322,171 @@ EncrypterResult *EvpMdContext::decrypt(const EncrypterData *in)
 
     this->cleanup();
 
-    if (not this->allocateMdContext() or not this->allocateInSig(this->getKeySize()))
+    bool valid = this->verify(in->getData(), in->getDataSize());
+
+    this->cleanup();
+
+    return new EncrypterResult(valid);
+}
+
+const unsigned char *EvpMdContext::signDetached(const unsigned char *in, unsigned int inlen, unsigned int &siglen)
+{
+    siglen = 0;
+
+    if (not in)
     {
-        return this->abort();
+        return nullptr;
     }
 
-    if (EVP_DigestVerifyInit(this->mdContext, nullptr, EVP_sha256(), nullptr, (EVP_PKEY *)this->getKey()->getKeyData()) != 1)
+    this->cleanup();
+
+    if (not this->createSignature(in, inlen))
     {
-        return this->abort();
+        this->cleanup();
+        return nullptr;
     }
 
-    int datalen;
-    const unsigned char *data = this->readSignedData(in, datalen);
+    // the signature stays in the output buffer until the next operation;
+    siglen = this->getOutBufferSize();
+    return this->getOutBuffer();
+}
 
-    if (not data or datalen < 0)
+bool EvpMdContext::verifyDetached(const unsigned char *in, unsigned int inlen, const unsigned char *sig, unsigned int siglen, VerificationCache *cache)
+{
+    if (not in or not sig)
     {
-        return this->abort();
+        return false;
     }
 
-    if (EVP_DigestVerifyUpdate(this->mdContext, data, datalen) != 1)
+    unsigned char digest[VERIFICATION_CACHE_DIGEST_SIZE];
+    bool cacheable = cache and this->createCacheDigest(in, inlen, sig, siglen, digest);
+
+    if (cacheable and cache->contains(digest))
     {
-        return this->abort();
+        return true;
     }
 
-    if (EVP_DigestVerifyFinal(this->mdContext, this->inSig, this->inSiglen) == 1)
+    bool valid = this->startOperation(false) and
+                 EVP_DigestVerify(this->mdContext, sig, siglen, in, inlen) == 1;
+
+    // a signature created with another digest is retried once with the digest it encloses, without
+    // changing the digest of this context, since the signature is not trusted;
+    EVP_PKEY *pkey = valid ? nullptr : this->getSuitableKey();
+    const EVP_MD *detected = pkey ? this->detectDigest(pkey, sig, siglen) : nullptr;
+
+    if (detected)
     {
-        return new EncrypterResult(true);
+        valid = this->initMdContext() and
+                EVP_DigestVerifyInit(this->mdContext, nullptr, detected, nullptr, pkey) == 1 and
+                EVP_DigestVerify(this->mdContext, sig, siglen, in, inlen) == 1;
     }
 
-    return new EncrypterResult(false);
+    this->cleanup();
+
+    if (valid and cacheable)
+    {
+        cache->insert(digest);
+    }
+
+    return valid;
+}
+
+const unsigned char *EvpMdContext::signDigest(const unsigned char *digest, unsigned int digestlen, unsigned int &siglen)
+{
+    siglen = 0;
+
+    if (not digest or not this->isSuitableDigest(digestlen))
+    {
+        return nullptr;
+    }
+
+    this->cleanup();
+
+    EVP_PKEY_CTX *pkeyContext = this->getDigestContext(true);
+    size_t size;
+
+    if (not pkeyContext or EVP_PKEY_sign(pkeyContext, nullptr, &size, digest, digestlen) != 1)
+    {
+        return nullptr;
+    }
+
+    if (not this->reserveOutBuffer(size) or EVP_PKEY_sign(pkeyContext, this->getOutBuffer(), &size, digest, digestlen) != 1)
+    {
+        return nullptr;
+    }
+
+    this->setOutBufferSize(size);
+
+    siglen = size;
+    return this->getOutBuffer();
+}
+
+bool EvpMdContext::verifyDigest(const unsigned char *digest, unsigned int digestlen, const unsigned char *sig, unsigned int siglen)
+{
+    if (not digest or not sig or not this->isSuitableDigest(digestlen))
+    {
+        return false;
+    }
+
+    EVP_PKEY_CTX *pkeyContext = this->getDigestContext(false);
+
+    return pkeyContext and EVP_PKEY_verify(pkeyContext, sig, siglen, digest, digestlen) == 1;
+}
+
+bool EvpMdContext::signInit()
+{
+    this->cleanup();
+
+    return not this->isEd25519() and this->startOperation(true);
+}
+
+bool EvpMdContext::signUpdate(const unsigned char *in, unsigned int inlen)
+{
+    return this->notNullMdContext() and in and EVP_DigestSignUpdate(this->mdContext, in, inlen) == 1;
+}
+
+const unsigned char *EvpMdContext::signFinal(unsigned int &siglen)
+{
+    size_t size;
+
+    siglen = 0;
+
+    if (not this->notNullMdContext() or EVP_DigestSignFinal(this->mdContext, nullptr, &size) != 1)
+    {
+        this->cleanup();
+        return nullptr;
+    }
+
+    if (not this->reserveOutBuffer(size) or EVP_DigestSignFinal(this->mdContext, this->getOutBuffer(), &size) != 1)
+    {
+        this->cleanup();
+        return nullptr;
+    }
+
+    EVP_MD_CTX_reset(this->mdContext);
+    this->setOutBufferSize(size);
+
+    siglen = size;
+    return this->getOutBuffer();
+}
+
+bool EvpMdContext::verifyInit()
+{
+    this->cleanup();
+
+    return not this->isEd25519() and this->startOperation(false);
+}
+
+bool EvpMdContext::verifyUpdate(const unsigned char *in, unsigned int inlen)
+{
+    return this->notNullMdContext() and in and EVP_DigestVerifyUpdate(this->mdContext, in, inlen) == 1;
+}
+
+bool EvpMdContext::verifyFinal(const unsigned char *sig, unsigned int siglen)
+{
+    bool valid = this->notNullMdContext() and sig and EVP_DigestVerifyFinal(this->mdContext, sig, siglen) == 1;
+
+    this->cleanup();
+
+    return valid;
 }
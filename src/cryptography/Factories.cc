@@ -1,3 +1,4 @@
+#include "cryptography/Factories.hh"
 #include "cryptography/CryptoContextBuilder.hh"
 
 extern "C"
@@ -42,6 +43,46 @@ extern "C"
         }
     }
 
+    CryptoContext *CreateSymmetricEncryptionContextFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useAes()
+                                     ->useEncryption()
+                                     ->noPlaintext()
+                                     ->deriveKey256(masterKey, purpose, peer, peerLen)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateSymmetricDecryptionContextFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useAes()
+                                     ->useDecryption()
+                                     ->noCiphertext()
+                                     ->deriveKey256(masterKey, purpose, peer, peerLen)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
     CryptoContext *CreateAsymmetricDecryptionContext(const char *key, const char *passphrase)
     {
         ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
@@ -201,4 +242,666 @@ extern "C"
             return nullptr;
         }
     }
-}
+
+    CryptoContext *CreateSignatureContextWithDigest(const char *key, DigestType digestType, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useDigest(digestType)
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->setKey(key, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateSignatureContextWithDigestFromFile(const char *path, DigestType digestType, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useDigest(digestType)
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->readKeyData(path, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519SignatureContext(const char *key, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->setKey(key, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519VerificationContext(const char *key)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->setKey(key)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519SignatureContextFromFile(const char *path, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->readKeyData(path, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519VerificationContextFromFile(const char *path)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->readKeyData(path)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useEncryption()
+                                     ->noPlaintext()
+                                     ->setKey(key, keylen, format)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useDecryption()
+                                     ->noCiphertext()
+                                     ->setKey(key, keylen, format, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateSignatureContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->setKey(key, keylen, format, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateVerificationContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->setKey(key, keylen, format)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519SignatureContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->setKey(key, keylen, format, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519VerificationContextFromKeyData(const unsigned char *key, unsigned int keylen, KeyFormat format)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->setKey(key, keylen, format)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeyFile(const char *path, KeyFormat format)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useEncryption()
+                                     ->noPlaintext()
+                                     ->readKeyData(path, format)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKeyFile(const char *path, KeyFormat format, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useDecryption()
+                                     ->noCiphertext()
+                                     ->readKeyData(path, format, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateSignatureContextFromKeyFile(const char *path, KeyFormat format, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->readKeyData(path, format, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateVerificationContextFromKeyFile(const char *path, KeyFormat format)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->readKeyData(path, format)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519SignatureContextFromKeyFile(const char *path, KeyFormat format, const char *passphrase)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->readKeyData(path, format, passphrase)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519VerificationContextFromKeyFile(const char *path, KeyFormat format)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->readKeyData(path, format)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeySet(KeySet *keySet, const char *name)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useEncryption()
+                                     ->noPlaintext()
+                                     ->shareKey(keySet ? keySet->getKey(name) : nullptr)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateVerificationContextFromKeySet(KeySet *keySet, const char *name)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->shareKey(keySet ? keySet->getKey(name) : nullptr)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519VerificationContextFromKeySet(KeySet *keySet, const char *name)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->shareKey(keySet ? keySet->getKey(name) : nullptr)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKey(const AsymmetricKey *key)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useEncryption()
+                                     ->noPlaintext()
+                                     ->shareKey(key)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKey(const AsymmetricKey *key)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useDecryption()
+                                     ->noCiphertext()
+                                     ->shareKey(key)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateSignatureContextFromKey(const AsymmetricKey *key)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->shareKey(key)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateVerificationContextFromKey(const AsymmetricKey *key)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->shareKey(key)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519SignatureContextFromKey(const AsymmetricKey *key)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->shareKey(key)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519VerificationContextFromKey(const AsymmetricKey *key)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->shareKey(key)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKeyHandle(const KeyHandle *handle)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useEncryption()
+                                     ->noPlaintext()
+                                     ->bindKeyHandle(handle)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKeyHandle(const KeyHandle *handle)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useDecryption()
+                                     ->noCiphertext()
+                                     ->bindKeyHandle(handle)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateSignatureContextFromKeyHandle(const KeyHandle *handle)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->bindKeyHandle(handle)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateVerificationContextFromKeyHandle(const KeyHandle *handle)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useRsa()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->bindKeyHandle(handle)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519SignatureContextFromKeyHandle(const KeyHandle *handle)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignature()
+                                     ->noPlaintext()
+                                     ->bindKeyHandle(handle)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+
+    CryptoContext *CreateEd25519VerificationContextFromKeyHandle(const KeyHandle *handle)
+    {
+        ICryptoContextBuilderType *builder = CryptoContextBuilder::Create();
+        try
+        {
+            CryptoContext *ctx = builder->useEd25519()
+                                     ->useSignatureVerification()
+                                     ->noCiphertext()
+                                     ->bindKeyHandle(handle)
+                                     ->build();
+            delete builder;
+            return ctx;
+        }
+        catch (std::exception)
+        {
+            delete builder;
+            return nullptr;
+        }
+    }
+}
\ No newline at end of file
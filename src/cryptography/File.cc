@@ -1,28 +1,33 @@
 #include "cryptography/File.hh"
+#include "cryptography/MappedFile.hh"
+
+#include <climits>
 
 const char *File::readFile(const char *path, unsigned int &len)
 {
-    std::string line;
-    std::string content;
-    std::ifstream in(path, std::ifstream::in);
+    MappedFile *file = MappedFile::Factory::create(path);
 
     len = 0;
 
-    if (not in.is_open())
+    if (not file or file->getSize() > UINT_MAX)
     {
+        delete file;
         return nullptr;
     }
 
-    while (getline(in, line))
+    len = file->getSize();
+
+    // the content is copied verbatim, so that line breaks (e.g. in PEM keys) are preserved;
+    char *data = new char[len + 1];
+
+    if (len > 0)
     {
-        content += line;
+        memcpy(data, file->getData(), len);
     }
 
-    len = content.size();
-
-    char *data = new char[len + 1];
-    memcpy(data, content.c_str(), content.size());
     data[len] = 0;
 
+    delete file;
+
     return data;
 }
@@ -0,0 +1,112 @@
+#include "cryptography/KeyAddress.hh"
+#include "cryptography/WorkerPool.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+
+// items are hashed in blocks, so that a task is not dominated by scheduling;
+#define ADDRESS_BATCH_TASKS_PER_THREAD 4
+
+static void BytesToHex(const unsigned char *bytes, unsigned int len, char *out)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (unsigned int i = 0; i < len; i++)
+    {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0F];
+    }
+
+    out[2 * len] = 0;
+}
+
+static bool DeriveAddresses(unsigned int count, unsigned char *addresses, bool *results, const std::function<bool(unsigned int, unsigned char *)> &derive)
+{
+    if (not addresses)
+    {
+        return false;
+    }
+
+    WorkerPool *pool = WorkerPool::getDefault();
+    unsigned int tasks = std::min(count, pool->getSize() * ADDRESS_BATCH_TASKS_PER_THREAD);
+    std::atomic<bool> all(true);
+
+    pool->run(tasks, [&](unsigned int task)
+              {
+        for (unsigned int i = (unsigned long)count * task / tasks; i < (unsigned long)count * (task + 1) / tasks; i++)
+        {
+            bool ok = derive(i, addresses + (unsigned long)i * ADDRESS_SIZE);
+
+            if (results)
+            {
+                results[i] = ok;
+            }
+
+            if (not ok)
+            {
+                all = false;
+            }
+        } });
+
+    return all;
+}
+
+extern "C"
+{
+    bool GetKeyAddress(const AsymmetricKey *key, unsigned char *address)
+    {
+        return key and key->getAddress(address);
+    }
+
+    bool GetKeyHexAddress(const AsymmetricKey *key, char *hexAddress)
+    {
+        unsigned char address[ADDRESS_SIZE];
+
+        if (not hexAddress or not GetKeyAddress(key, address))
+        {
+            return false;
+        }
+
+        BytesToHex(address, ADDRESS_SIZE, hexAddress);
+
+        return true;
+    }
+
+    bool GetPemAddress(const char *pem, unsigned char *address)
+    {
+        AsymmetricKey *key = pem and address ? AsymmetricKey::Factory::createPublicKeyFromPem(pem, strlen(pem)) : nullptr;
+        bool ok = key and key->getAddress(address);
+
+        delete key;
+
+        return ok;
+    }
+
+    bool GetPemHexAddress(const char *pem, char *hexAddress)
+    {
+        unsigned char address[ADDRESS_SIZE];
+
+        if (not hexAddress or not GetPemAddress(pem, address))
+        {
+            return false;
+        }
+
+        BytesToHex(address, ADDRESS_SIZE, hexAddress);
+
+        return true;
+    }
+
+    bool GetKeyAddresses(const AsymmetricKey **keys, unsigned int count, unsigned char *addresses, bool *results)
+    {
+        return keys and DeriveAddresses(count, addresses, results, [&](unsigned int i, unsigned char *address)
+                                        { return GetKeyAddress(keys[i], address); });
+    }
+
+    bool GetPemAddresses(const char **pems, unsigned int count, unsigned char *addresses, bool *results)
+    {
+        return pems and DeriveAddresses(count, addresses, results, [&](unsigned int i, unsigned char *address)
+                                        { return GetPemAddress(pems[i], address); });
+    }
+}
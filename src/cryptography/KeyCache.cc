@@ -0,0 +1,156 @@
+#include "cryptography/KeyCache.hh"
+
+#include <cstring>
+
+bool KeyCache::computeDigest(const unsigned char *keyData, unsigned int len, KeyFormat format, const char *passphrase, unsigned char *digest)
+{
+    if (not keyData or not digest)
+    {
+        return false;
+    }
+
+    EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+
+    // the passphrase is length-prefixed, so it cannot run into the key data;
+    unsigned int passphraseLen = passphrase ? strlen(passphrase) : 0;
+    unsigned char header[] = {(unsigned char)format, passphrase != nullptr,
+                              (unsigned char)(passphraseLen >> 24), (unsigned char)(passphraseLen >> 16),
+                              (unsigned char)(passphraseLen >> 8), (unsigned char)passphraseLen};
+
+    bool ok = mdContext and
+              EVP_DigestInit_ex(mdContext, EVP_sha256(), nullptr) == 1 and
+              EVP_DigestUpdate(mdContext, header, sizeof(header)) == 1 and
+              EVP_DigestUpdate(mdContext, passphrase, passphraseLen) == 1 and
+              EVP_DigestUpdate(mdContext, keyData, len) == 1 and
+              EVP_DigestFinal_ex(mdContext, digest, nullptr) == 1;
+
+    EVP_MD_CTX_free(mdContext);
+
+    return ok;
+}
+
+void KeyCache::evict(unsigned int size)
+{
+    while (this->entries.size() > size)
+    {
+        this->erase(this->entries.find(this->usage.back()));
+        this->evictions++;
+    }
+}
+
+EVP_PKEY *KeyCache::get(const unsigned char *digest)
+{
+    std::string key((const char *)digest, KEY_CACHE_DIGEST_SIZE);
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto entry = this->entries.find(key);
+
+    if (entry == this->entries.end() or EVP_PKEY_up_ref(entry->second.pkey) != 1)
+    {
+        this->misses++;
+        return nullptr;
+    }
+
+    this->usage.splice(this->usage.begin(), this->usage, entry->second.usage);
+    this->hits++;
+
+    return entry->second.pkey;
+}
+
+void KeyCache::put(const unsigned char *digest, EVP_PKEY *pkey)
+{
+    std::string key((const char *)digest, KEY_CACHE_DIGEST_SIZE);
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    // another thread may have parsed the same key meanwhile;
+    if (this->capacity == 0 or this->entries.count(key) or EVP_PKEY_up_ref(pkey) != 1)
+    {
+        return;
+    }
+
+    this->evict(this->capacity - 1);
+
+    this->usage.push_front(key);
+    this->entries[key] = {pkey, this->usage.begin()};
+}
+
+void KeyCache::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    while (not this->entries.empty())
+    {
+        this->erase(this->entries.begin());
+    }
+}
+
+void KeyCache::setCapacity(unsigned int capacity)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->capacity = capacity;
+    this->evict(capacity);
+}
+
+unsigned int KeyCache::getSize()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    return this->entries.size();
+}
+
+KeyCache *KeyCache::getInstance()
+{
+    // never destroyed, so no key is released after OpenSSL has been cleaned up at exit;
+    static KeyCache *cache = new KeyCache(KEY_CACHE_DEFAULT_CAPACITY);
+
+    return cache;
+}
+
+KeyCache *KeyCache::getUnlockedInstance()
+{
+    static KeyCache *cache = new KeyCache(0);
+
+    return cache;
+}
+
+static void GetStats(KeyCache *cache, unsigned long &hits, unsigned long &misses, unsigned long &evictions, unsigned int &size)
+{
+    hits = cache->getHits();
+    misses = cache->getMisses();
+    evictions = cache->getEvictions();
+    size = cache->getSize();
+}
+
+extern "C"
+{
+    void SetKeyCacheCapacity(unsigned int capacity)
+    {
+        KeyCache::getInstance()->setCapacity(capacity);
+    }
+
+    void ClearKeyCache()
+    {
+        KeyCache::getInstance()->clear();
+    }
+
+    void GetKeyCacheStats(unsigned long &hits, unsigned long &misses, unsigned long &evictions, unsigned int &size)
+    {
+        GetStats(KeyCache::getInstance(), hits, misses, evictions, size);
+    }
+
+    void SetUnlockedKeyCacheCapacity(unsigned int capacity)
+    {
+        KeyCache::getUnlockedInstance()->setCapacity(capacity);
+    }
+
+    void ClearUnlockedKeyCache()
+    {
+        KeyCache::getUnlockedInstance()->clear();
+    }
+
+    void GetUnlockedKeyCacheStats(unsigned long &hits, unsigned long &misses, unsigned long &evictions, unsigned int &size)
+    {
+        GetStats(KeyCache::getUnlockedInstance(), hits, misses, evictions, size);
+    }
+}
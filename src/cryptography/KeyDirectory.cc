@@ -0,0 +1,261 @@
+#include "cryptography/KeyDirectory.hh"
+#include "cryptography/Constants.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+static const unsigned char KeyDirectoryMagic[] = {'A', 'K', 'D', '1', 0, 0, 0, 0};
+
+static void WriteBigEndian(unsigned char *out, unsigned long value, unsigned int size)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        out[size - 1 - i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static unsigned long ReadBigEndian(const unsigned char *in, unsigned int size)
+{
+    unsigned long value = 0;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        value = (value << 8) | in[i];
+    }
+
+    return value;
+}
+
+KeyDirectory::~KeyDirectory()
+{
+    for (auto &entry : this->keys)
+    {
+        delete entry.second;
+    }
+
+    delete this->file;
+}
+
+bool KeyDirectory::readHeader()
+{
+    const unsigned char *data = this->file->getData();
+    unsigned long size = this->file->getSize();
+
+    if (size < KEY_DIRECTORY_HEADER_SIZE or memcmp(data, KeyDirectoryMagic, sizeof(KeyDirectoryMagic)))
+    {
+        return false;
+    }
+
+    this->count = ReadBigEndian(data + sizeof(KeyDirectoryMagic), 8);
+
+    // entries are validated on lookup, so opening does not depend on the number of keys;
+    return this->count <= (size - KEY_DIRECTORY_HEADER_SIZE) / KEY_DIRECTORY_ENTRY_SIZE;
+}
+
+bool KeyDirectory::find(const unsigned char *address, unsigned long &index) const
+{
+    if (not address)
+    {
+        return false;
+    }
+
+    unsigned long low = 0;
+    unsigned long high = this->count;
+
+    while (low < high)
+    {
+        unsigned long middle = low + (high - low) / 2;
+        int order = memcmp(this->getEntry(middle), address, ADDRESS_SIZE);
+
+        if (order == 0)
+        {
+            index = middle;
+            return true;
+        }
+
+        if (order < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return false;
+}
+
+const unsigned char *KeyDirectory::getKeyData(const unsigned char *address, unsigned int &len) const
+{
+    unsigned long index;
+
+    len = 0;
+
+    if (not this->find(address, index))
+    {
+        return nullptr;
+    }
+
+    const unsigned char *entry = this->getEntry(index);
+    unsigned long offset = ReadBigEndian(entry + ADDRESS_SIZE, 8);
+    unsigned long size = ReadBigEndian(entry + ADDRESS_SIZE + 8, 4);
+
+    if (offset > this->file->getSize() or size > this->file->getSize() - offset)
+    {
+        return nullptr;
+    }
+
+    len = size;
+
+    return this->file->getData() + offset;
+}
+
+const AsymmetricKey *KeyDirectory::getKey(const unsigned char *address)
+{
+    unsigned long index;
+
+    if (not this->find(address, index))
+    {
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto parsed = this->keys.find(index);
+
+        if (parsed != this->keys.end())
+        {
+            return parsed->second;
+        }
+    }
+
+    // parsed outside the lock, so that lookups of other keys are not held up;
+    unsigned int len;
+    const unsigned char *keyData = this->getKeyData(address, len);
+    AsymmetricKey *key = keyData ? AsymmetricKey::Factory::createPublicKeyFromData(keyData, len, DerKeyFormat) : nullptr;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto parsed = this->keys.emplace(index, key);
+
+    // another thread may have parsed the same key meanwhile;
+    if (not parsed.second)
+    {
+        delete key;
+    }
+
+    return parsed.first->second;
+}
+
+bool KeyDirectory::write(const char *path, const unsigned char **addresses, const unsigned char **keys, const unsigned int *keyLens, unsigned long count)
+{
+    if (not path or (count and (not addresses or not keys or not keyLens)))
+    {
+        return false;
+    }
+
+    std::vector<unsigned long> order(count);
+
+    for (unsigned long i = 0; i < count; i++)
+    {
+        if (not addresses[i] or not keys[i])
+        {
+            return false;
+        }
+
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&](unsigned long a, unsigned long b)
+              { return memcmp(addresses[a], addresses[b], ADDRESS_SIZE) < 0; });
+
+    std::vector<unsigned char> index(KEY_DIRECTORY_HEADER_SIZE + count * KEY_DIRECTORY_ENTRY_SIZE);
+    unsigned long offset = index.size();
+
+    memcpy(index.data(), KeyDirectoryMagic, sizeof(KeyDirectoryMagic));
+    WriteBigEndian(index.data() + sizeof(KeyDirectoryMagic), count, 8);
+
+    for (unsigned long i = 0; i < count; i++)
+    {
+        unsigned char *entry = index.data() + KEY_DIRECTORY_HEADER_SIZE + i * KEY_DIRECTORY_ENTRY_SIZE;
+
+        // a lookup would only ever find one of two entries with the same address;
+        if (i > 0 and memcmp(addresses[order[i - 1]], addresses[order[i]], ADDRESS_SIZE) == 0)
+        {
+            return false;
+        }
+
+        memcpy(entry, addresses[order[i]], ADDRESS_SIZE);
+        WriteBigEndian(entry + ADDRESS_SIZE, offset, 8);
+        WriteBigEndian(entry + ADDRESS_SIZE + 8, keyLens[order[i]], 4);
+
+        offset += keyLens[order[i]];
+    }
+
+    std::string temporary = std::string(path) + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+
+    out.write((const char *)index.data(), index.size());
+
+    for (unsigned long i = 0; i < count and out; i++)
+    {
+        out.write((const char *)keys[order[i]], keyLens[order[i]]);
+    }
+
+    out.close();
+
+    if (not out or rename(temporary.c_str(), path) != 0)
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+KeyDirectory *KeyDirectory::Factory::create(const char *path)
+{
+    // lookups touch a handful of pages each, so the file is not read ahead;
+    MappedFile *file = MappedFile::Factory::create(path, false);
+
+    if (not file)
+    {
+        return nullptr;
+    }
+
+    KeyDirectory *directory = new KeyDirectory(file);
+
+    if (not directory->readHeader())
+    {
+        delete directory;
+        return nullptr;
+    }
+
+    return directory;
+}
+
+extern "C"
+{
+    bool WriteKeyDirectory(const char *path, const unsigned char **addresses, const unsigned char **keys, const unsigned int *keyLens, unsigned long count)
+    {
+        return KeyDirectory::write(path, addresses, keys, keyLens, count);
+    }
+
+    KeyDirectory *OpenKeyDirectory(const char *path)
+    {
+        return KeyDirectory::Factory::create(path);
+    }
+
+    void FreeKeyDirectory(KeyDirectory *directory)
+    {
+        delete directory;
+    }
+
+    unsigned long GetKeyDirectorySize(const KeyDirectory *directory)
+    {
+        return directory ? directory->getSize() : 0;
+    }
+}
@@ -0,0 +1,91 @@
+#include "cryptography/KeyHandle.hh"
+
+#include <thread>
+
+EVP_PKEY *KeyHandle::acquire(unsigned long &version) const
+{
+    unsigned long epoch;
+
+    // a reader counts in the epoch it entered; if the epoch moved on meanwhile, the writer may
+    // already have waited for that epoch, so the reader enters again;
+    while (true)
+    {
+        epoch = this->epoch;
+        this->readers[epoch & 1]++;
+
+        if (this->epoch == epoch)
+        {
+            break;
+        }
+
+        this->readers[epoch & 1]--;
+    }
+
+    version = this->version;
+    EVP_PKEY *pkey = this->current;
+
+    if (pkey and EVP_PKEY_up_ref(pkey) != 1)
+    {
+        pkey = nullptr;
+    }
+
+    this->readers[epoch & 1]--;
+
+    return pkey;
+}
+
+bool KeyHandle::rotate(const AsymmetricKey *key)
+{
+    EVP_PKEY *pkey = key and key->getKeyType() == this->keyType ? key->acquire() : nullptr;
+
+    std::lock_guard<std::mutex> lock(this->rotation);
+
+    // buffers sized for the current key must fit the new one, so only keys of the same algorithm
+    // and size are accepted;
+    EVP_PKEY *active = this->current;
+
+    if (not pkey or (active and (EVP_PKEY_get_base_id(pkey) != EVP_PKEY_get_base_id(active) or EVP_PKEY_get_bits(pkey) != EVP_PKEY_get_bits(active))))
+    {
+        EVP_PKEY_free(pkey);
+        return false;
+    }
+
+    // the version is bumped after the swap, so a reader seeing the new version gets the new key;
+    EVP_PKEY *previous = this->current.exchange(pkey);
+    this->version++;
+
+    // readers that entered before the epoch changed may still be about to reference the previous key;
+    unsigned long epoch = this->epoch++;
+
+    while (this->readers[epoch & 1] != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    EVP_PKEY_free(previous);
+
+    return true;
+}
+
+extern "C"
+{
+    KeyHandle *CreateKeyHandle(const AsymmetricKey *key)
+    {
+        return KeyHandle::Factory::create(key);
+    }
+
+    bool RotateKey(KeyHandle *handle, const AsymmetricKey *key)
+    {
+        return handle and handle->rotate(key);
+    }
+
+    unsigned long GetKeyHandleVersion(const KeyHandle *handle)
+    {
+        return handle ? handle->getVersion() : 0;
+    }
+
+    void FreeKeyHandle(KeyHandle *handle)
+    {
+        delete handle;
+    }
+}
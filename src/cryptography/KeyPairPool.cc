@@ -0,0 +1,154 @@
+#include "cryptography/KeyPairPool.hh"
+
+KeyPairPool::KeyPairPool(KeyPairType type, unsigned int bits, unsigned int depth, unsigned int threads)
+{
+    this->type = type;
+    this->bits = bits;
+    this->depth = depth;
+    this->pending = 0;
+    this->stopping = false;
+    this->hits = 0;
+    this->misses = 0;
+
+    for (unsigned int i = 0; i < threads; i++)
+    {
+        this->workers.emplace_back(&KeyPairPool::work, this);
+    }
+}
+
+KeyPairPool::~KeyPairPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+
+    this->refill.notify_all();
+
+    for (std::thread &worker : this->workers)
+    {
+        worker.join();
+    }
+
+    for (AsymmetricKey *key : this->keys)
+    {
+        delete key;
+    }
+}
+
+void KeyPairPool::work()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (true)
+    {
+        // keys being generated count towards the depth, so that threads do not overshoot it;
+        this->refill.wait(lock, [&]
+                          { return this->stopping or this->keys.size() + this->pending < this->depth; });
+
+        if (this->stopping)
+        {
+            return;
+        }
+
+        this->pending++;
+        lock.unlock();
+
+        AsymmetricKey *key = AsymmetricKey::Factory::generatePrivateKey(this->type, this->bits);
+
+        lock.lock();
+        this->pending--;
+
+        if (not key)
+        {
+            // generation only fails for invalid parameters; retrying would spin;
+            return;
+        }
+
+        this->keys.push_back(key);
+    }
+}
+
+AsymmetricKey *KeyPairPool::take()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        if (not this->keys.empty())
+        {
+            AsymmetricKey *key = this->keys.front();
+            this->keys.pop_front();
+            this->hits++;
+            this->refill.notify_one();
+
+            return key;
+        }
+    }
+
+    this->misses++;
+
+    return AsymmetricKey::Factory::generatePrivateKey(this->type, this->bits);
+}
+
+unsigned int KeyPairPool::getSize()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    return this->keys.size();
+}
+
+extern "C"
+{
+    AsymmetricKey *GenerateKeyPair(KeyPairType type, unsigned int bits)
+    {
+        return AsymmetricKey::Factory::generatePrivateKey(type, bits);
+    }
+
+    AsymmetricKey *GetPublicKey(const AsymmetricKey *privateKey)
+    {
+        return AsymmetricKey::Factory::createPublicKeyFromPrivateKey(privateKey);
+    }
+
+    const unsigned char *ExportKey(const AsymmetricKey *key, KeyFormat format, const char *passphrase, int &len)
+    {
+        unsigned int keylen = 0;
+        const unsigned char *out = key ? key->exportKey(format, keylen, passphrase) : nullptr;
+
+        len = out ? keylen : -1;
+        return out;
+    }
+
+    void FreeKey(AsymmetricKey *key)
+    {
+        delete key;
+    }
+
+    KeyPairPool *CreateKeyPairPool(KeyPairType type, unsigned int bits, unsigned int depth, unsigned int threads)
+    {
+        return new KeyPairPool(type, bits, depth, threads);
+    }
+
+    AsymmetricKey *TakeKeyPair(KeyPairPool *pool)
+    {
+        return pool ? pool->take() : nullptr;
+    }
+
+    void FreeKeyPairPool(KeyPairPool *pool)
+    {
+        delete pool;
+    }
+
+    bool GetKeyPairPoolStats(KeyPairPool *pool, unsigned long &hits, unsigned long &misses, unsigned int &size)
+    {
+        if (not pool)
+        {
+            return false;
+        }
+
+        hits = pool->getHits();
+        misses = pool->getMisses();
+        size = pool->getSize();
+
+        return true;
+    }
+}
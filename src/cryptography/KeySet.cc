@@ -0,0 +1,230 @@
+#include "cryptography/KeySet.hh"
+#include "cryptography/MappedFile.hh"
+#include "cryptography/WorkerPool.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <sys/stat.h>
+
+KeySet::~KeySet()
+{
+    for (std::unique_ptr<Entry> &entry : this->entries)
+    {
+        delete entry->key;
+    }
+}
+
+void KeySet::add(const std::string &name, const std::string &path)
+{
+    // a name listed twice refers to its first occurrence;
+    if (this->index.count(name))
+    {
+        return;
+    }
+
+    Entry *entry = new Entry();
+    entry->name = name;
+    entry->path = path;
+    entry->key = nullptr;
+
+    this->index[name] = this->entries.size();
+    this->entries.emplace_back(entry);
+}
+
+bool KeySet::listDirectory(const char *path)
+{
+    DIR *dir = path ? opendir(path) : nullptr;
+
+    if (not dir)
+    {
+        return false;
+    }
+
+    std::vector<std::string> names;
+    std::string directory = std::string(path) + "/";
+
+    for (struct dirent *file = readdir(dir); file; file = readdir(dir))
+    {
+        struct stat info;
+
+        if (file->d_name[0] != '.' and stat((directory + file->d_name).c_str(), &info) == 0 and S_ISREG(info.st_mode))
+        {
+            names.push_back(file->d_name);
+        }
+    }
+
+    closedir(dir);
+
+    // directory order is arbitrary; indexes must not depend on it;
+    std::sort(names.begin(), names.end());
+
+    for (const std::string &name : names)
+    {
+        this->add(name, directory + name);
+    }
+
+    return true;
+}
+
+bool KeySet::readManifest(const char *path)
+{
+    MappedFile *manifest = MappedFile::Factory::create(path);
+
+    if (not manifest)
+    {
+        return false;
+    }
+
+    std::string file = path;
+    std::string::size_type separator = file.rfind('/');
+    std::string directory = separator == std::string::npos ? "" : file.substr(0, separator + 1);
+
+    const char *content = (const char *)manifest->getData();
+    unsigned long size = manifest->getSize();
+
+    for (unsigned long start = 0, end; start < size; start = end + 1)
+    {
+        end = std::find(content + start, content + size, '\n') - content;
+
+        std::string name(content + start, end - start);
+        name.erase(name.find_last_not_of(" \t\r") + 1);
+        name.erase(0, name.find_first_not_of(" \t"));
+
+        if (not name.empty() and name[0] != '#')
+        {
+            this->add(name, name[0] == '/' ? name : directory + name);
+        }
+    }
+
+    delete manifest;
+
+    return true;
+}
+
+const AsymmetricKey *KeySet::parse(Entry &entry)
+{
+    std::call_once(entry.parsed, [&]
+                   {
+        AsymmetricKey *key = AsymmetricKey::Factory::createPublicKey();
+
+        if (not key->readKeyFile(entry.path.c_str(), this->format))
+        {
+            delete key;
+            key = nullptr;
+            this->failed++;
+        }
+
+        entry.key = key;
+        this->loaded++; });
+
+    return entry.key;
+}
+
+void KeySet::load(KeySetProgress progress, void *arg)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned int total = this->getSize();
+
+    WorkerPool::getDefault()->run(total, [&](unsigned int i)
+                                  {
+        this->parse(*this->entries[i]);
+
+        if (progress)
+        {
+            progress(this->loaded, total, arg);
+        } });
+
+    this->loadTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+const AsymmetricKey *KeySet::getKey(const char *name)
+{
+    // the index is complete once the set is created, so it is only ever read here;
+    auto it = name ? this->index.find(name) : this->index.end();
+
+    return it != this->index.end() ? this->getKey(it->second) : nullptr;
+}
+
+const AsymmetricKey *KeySet::getKey(unsigned int index)
+{
+    return index < this->entries.size() ? this->parse(*this->entries[index]) : nullptr;
+}
+
+KeySet *KeySet::Factory::createFromDirectory(const char *path, KeyFormat format, bool lazy, KeySetProgress progress, void *arg)
+{
+    KeySet *keySet = new KeySet(format);
+
+    if (not keySet->listDirectory(path))
+    {
+        delete keySet;
+        return nullptr;
+    }
+
+    if (not lazy)
+    {
+        keySet->load(progress, arg);
+    }
+
+    return keySet;
+}
+
+KeySet *KeySet::Factory::createFromManifest(const char *path, KeyFormat format, bool lazy, KeySetProgress progress, void *arg)
+{
+    KeySet *keySet = new KeySet(format);
+
+    if (not keySet->readManifest(path))
+    {
+        delete keySet;
+        return nullptr;
+    }
+
+    if (not lazy)
+    {
+        keySet->load(progress, arg);
+    }
+
+    return keySet;
+}
+
+extern "C"
+{
+    KeySet *LoadKeySetFromDirectory(const char *path, KeyFormat format, bool lazy, KeySetProgress progress, void *arg)
+    {
+        return KeySet::Factory::createFromDirectory(path, format, lazy, progress, arg);
+    }
+
+    KeySet *LoadKeySetFromManifest(const char *path, KeyFormat format, bool lazy, KeySetProgress progress, void *arg)
+    {
+        return KeySet::Factory::createFromManifest(path, format, lazy, progress, arg);
+    }
+
+    void FreeKeySet(KeySet *keySet)
+    {
+        delete keySet;
+    }
+
+    unsigned int GetKeySetSize(const KeySet *keySet)
+    {
+        return keySet ? keySet->getSize() : 0;
+    }
+
+    const char *GetKeySetKeyName(const KeySet *keySet, unsigned int index)
+    {
+        return keySet ? keySet->getName(index) : nullptr;
+    }
+
+    bool GetKeySetStats(const KeySet *keySet, unsigned int &loaded, unsigned int &failed, unsigned long &loadTime)
+    {
+        if (not keySet)
+        {
+            return false;
+        }
+
+        loaded = keySet->getLoadedCount();
+        failed = keySet->getFailedCount();
+        loadTime = keySet->getLoadTime();
+
+        return true;
+    }
+}
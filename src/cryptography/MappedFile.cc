@@ -0,0 +1,63 @@
+#include "cryptography/MappedFile.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool MappedFile::map(const char *path, bool readAhead)
+{
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0 and S_ISREG(info.st_mode);
+
+    // an empty file cannot be mapped, but it is a valid (empty) view;
+    if (ok and info.st_size > 0)
+    {
+        void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+            ok = false;
+        }
+        else
+        {
+            this->data = (const unsigned char *)mapping;
+            this->size = info.st_size;
+
+            if (readAhead)
+            {
+                this->advise(MADV_SEQUENTIAL);
+                this->advise(MADV_WILLNEED);
+            }
+            else
+            {
+                this->advise(MADV_RANDOM);
+            }
+        }
+    }
+
+    // the mapping keeps its own reference to the file;
+    close(fd);
+
+    return ok;
+}
+
+MappedFile::~MappedFile()
+{
+    if (this->data)
+    {
+        munmap((void *)this->data, this->size);
+    }
+}
+
+bool MappedFile::advise(int advice) const
+{
+    return not this->data or madvise((void *)this->data, this->size, advice) == 0;
+}
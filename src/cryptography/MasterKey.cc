@@ -0,0 +1,149 @@
+#include "cryptography/MasterKey.hh"
+#include "cryptography/Factories.hh"
+#include "cryptography/WorkerPool.hh"
+
+#include <atomic>
+#include <cstring>
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+
+static bool RunHkdf(EVP_KDF *kdf, int mode, const unsigned char *key, unsigned int keyLen, const unsigned char *salt, unsigned int saltLen,
+                    const unsigned char *info, unsigned int infoLen, unsigned char *out)
+{
+    EVP_KDF_CTX *kctx = EVP_KDF_CTX_new(kdf);
+
+    if (not kctx)
+    {
+        return false;
+    }
+
+    OSSL_PARAM params[6], *p = params;
+
+    *p++ = OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, (char *)"SHA256", 0);
+    *p++ = OSSL_PARAM_construct_int(OSSL_KDF_PARAM_MODE, &mode);
+    *p++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_KEY, (void *)key, keyLen);
+
+    if (salt and saltLen)
+    {
+        *p++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SALT, (void *)salt, saltLen);
+    }
+
+    if (info)
+    {
+        *p++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_INFO, (void *)info, infoLen);
+    }
+
+    *p = OSSL_PARAM_construct_end();
+
+    bool ok = EVP_KDF_derive(kctx, out, SYMMETRIC_KEY_SIZE, params) == 1;
+
+    EVP_KDF_CTX_free(kctx);
+
+    return ok;
+}
+
+static bool CreateContextsFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char **peers, const unsigned int *peerLens, unsigned int count, CryptoContext **ctx,
+                                        CryptoContext *(*create)(const MasterKey *, const char *, const unsigned char *, unsigned int))
+{
+    if (not masterKey or not peers or not peerLens or not ctx)
+    {
+        return false;
+    }
+
+    std::atomic<bool> all(true);
+
+    WorkerPool::getDefault()->run(count, [&](unsigned int i)
+                                  {
+        if (not(ctx[i] = create(masterKey, purpose, peers[i], peerLens[i])))
+        {
+            all = false;
+        } });
+
+    return all;
+}
+
+MasterKey::~MasterKey()
+{
+    OPENSSL_cleanse(this->prk, sizeof(this->prk));
+    EVP_KDF_free(this->kdf);
+}
+
+bool MasterKey::extract(const unsigned char *key, unsigned int keyLen, const unsigned char *salt, unsigned int saltLen)
+{
+    this->kdf = EVP_KDF_fetch(nullptr, OSSL_KDF_NAME_HKDF, nullptr);
+
+    return this->kdf and RunHkdf(this->kdf, EVP_KDF_HKDF_MODE_EXTRACT_ONLY, key, keyLen, salt, saltLen, nullptr, 0, this->prk);
+}
+
+bool MasterKey::deriveKey(const char *purpose, const unsigned char *peer, unsigned int peerLen, unsigned char *subkey) const
+{
+    if (not purpose or not subkey or (peerLen and not peer))
+    {
+        return false;
+    }
+
+    // the purpose is NUL-terminated, so it can never run into the peer;
+    unsigned int purposeLen = strlen(purpose) + 1;
+    unsigned char info[MASTER_KEY_MAX_INFO_SIZE];
+
+    if (purposeLen > MASTER_KEY_MAX_INFO_SIZE or peerLen > MASTER_KEY_MAX_INFO_SIZE - purposeLen)
+    {
+        return false;
+    }
+
+    memcpy(info, purpose, purposeLen);
+
+    if (peerLen)
+    {
+        memcpy(info + purposeLen, peer, peerLen);
+    }
+
+    return RunHkdf(this->kdf, EVP_KDF_HKDF_MODE_EXPAND_ONLY, this->prk, sizeof(this->prk), nullptr, 0, info, purposeLen + peerLen, subkey);
+}
+
+MasterKey *MasterKey::Factory::create(const unsigned char *key, unsigned int keyLen, const unsigned char *salt, unsigned int saltLen)
+{
+    // HKDF does not make up for a weak master key;
+    if (not key or keyLen < SYMMETRIC_KEY_SIZE)
+    {
+        return nullptr;
+    }
+
+    MasterKey *masterKey = new MasterKey();
+
+    if (not masterKey->extract(key, keyLen, salt, saltLen))
+    {
+        delete masterKey;
+        return nullptr;
+    }
+
+    return masterKey;
+}
+
+extern "C"
+{
+    MasterKey *CreateMasterKey(const unsigned char *key, unsigned int keyLen, const unsigned char *salt, unsigned int saltLen)
+    {
+        return MasterKey::Factory::create(key, keyLen, salt, saltLen);
+    }
+
+    void FreeMasterKey(MasterKey *masterKey)
+    {
+        delete masterKey;
+    }
+
+    bool DeriveSubkey(const MasterKey *masterKey, const char *purpose, const unsigned char *peer, unsigned int peerLen, unsigned char *subkey)
+    {
+        return masterKey and masterKey->deriveKey(purpose, peer, peerLen, subkey);
+    }
+
+    bool CreateSymmetricEncryptionContextsFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char **peers, const unsigned int *peerLens, unsigned int count, CryptoContext **ctx)
+    {
+        return CreateContextsFromMasterKey(masterKey, purpose, peers, peerLens, count, ctx, CreateSymmetricEncryptionContextFromMasterKey);
+    }
+
+    bool CreateSymmetricDecryptionContextsFromMasterKey(const MasterKey *masterKey, const char *purpose, const unsigned char **peers, const unsigned int *peerLens, unsigned int count, CryptoContext **ctx)
+    {
+        return CreateContextsFromMasterKey(masterKey, purpose, peers, peerLens, count, ctx, CreateSymmetricDecryptionContextFromMasterKey);
+    }
+}
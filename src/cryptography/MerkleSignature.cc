@@ -0,0 +1,285 @@
+#include "cryptography/MerkleSignature.hh"
+#include "cryptography/Signatures.hh"
+#include "cryptography/EvpMdContext.hh"
+
+#include <cstring>
+
+static const unsigned char MerkleSignatureMagic[] = {'A', 'M', 'T', '1'};
+static const unsigned char BatchSignatureMagic[] = {'A', 'M', 'B', '1'};
+
+static void WriteBigEndian(unsigned char *out, unsigned long value, unsigned int size)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        out[size - 1 - i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static unsigned long ReadBigEndian(const unsigned char *in, unsigned int size)
+{
+    unsigned long value = 0;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        value = (value << 8) | in[i];
+    }
+
+    return value;
+}
+
+static void WriteHeader(unsigned char *header, unsigned int leafSize, unsigned long dataLen, const unsigned char *root)
+{
+    memcpy(header, MerkleSignatureMagic, 4);
+    WriteBigEndian(header + 4, leafSize, 4);
+    WriteBigEndian(header + 8, dataLen, 8);
+    memcpy(header + 16, root, MERKLE_HASH_SIZE);
+}
+
+static bool ReadHeader(const unsigned char *signature, unsigned int signatureLen, unsigned int &leafSize, unsigned long &dataLen)
+{
+    if (not signature or signatureLen <= MERKLE_SIGNATURE_HEADER_SIZE or memcmp(signature, MerkleSignatureMagic, 4) != 0)
+    {
+        return false;
+    }
+
+    leafSize = ReadBigEndian(signature + 4, 4);
+    dataLen = ReadBigEndian(signature + 8, 8);
+
+    return leafSize > 0;
+}
+
+static bool VerifyMerkleRoot(CryptoContext *ctx, const unsigned char *root, const unsigned char *signature, unsigned int signatureLen)
+{
+    return memcmp(signature + 16, root, MERKLE_HASH_SIZE) == 0 and
+           VerifyDetachedSignature(ctx, signature, MERKLE_SIGNATURE_HEADER_SIZE, signature + MERKLE_SIGNATURE_HEADER_SIZE,
+                                   signatureLen - MERKLE_SIGNATURE_HEADER_SIZE);
+}
+
+static bool VerifyBatchRoot(CryptoContext *ctx, const unsigned char *signature, unsigned int rootSignatureLen)
+{
+    EvpMdContext *cipher = ctx->isSetForVerifying() ? ctx->getSignatureCipher() : nullptr;
+
+    if (not cipher)
+    {
+        return false;
+    }
+
+    return cipher->verifyDetached(signature, BATCH_SIGNATURE_SIGNED_SIZE, signature + BATCH_SIGNATURE_HEADER_SIZE, rootSignatureLen);
+}
+
+extern "C"
+{
+    MerkleTree *CreateMerkleTree(const unsigned char *data, unsigned long dataLen, unsigned int leafSize)
+    {
+        return MerkleTree::Factory::create(data, dataLen, leafSize);
+    }
+
+    void FreeMerkleTree(MerkleTree *tree)
+    {
+        delete tree;
+    }
+
+    const unsigned char *GetMerkleProof(const MerkleTree *tree, unsigned long index, int &proofLen)
+    {
+        std::vector<unsigned char> proof;
+
+        proofLen = -1;
+
+        if (not tree or not tree->getProof(index, proof))
+        {
+            return nullptr;
+        }
+
+        unsigned char *out = new unsigned char[proof.size() + 1];
+        memcpy(out, proof.data(), proof.size());
+
+        proofLen = proof.size();
+        return out;
+    }
+
+    const unsigned char *SignMerkleTree(CryptoContext *ctx, const MerkleTree *tree, int &signatureLen)
+    {
+        signatureLen = -1;
+
+        if (not tree)
+        {
+            return nullptr;
+        }
+
+        unsigned char header[MERKLE_SIGNATURE_HEADER_SIZE];
+        WriteHeader(header, tree->getLeafSize(), tree->getDataLen(), tree->getRoot());
+
+        int siglen;
+        const unsigned char *sig = SignDataDetached(ctx, header, MERKLE_SIGNATURE_HEADER_SIZE, siglen);
+
+        if (not sig)
+        {
+            return nullptr;
+        }
+
+        unsigned char *out = new unsigned char[MERKLE_SIGNATURE_HEADER_SIZE + siglen + 1];
+        memcpy(out, header, MERKLE_SIGNATURE_HEADER_SIZE);
+        memcpy(out + MERKLE_SIGNATURE_HEADER_SIZE, sig, siglen);
+
+        signatureLen = MERKLE_SIGNATURE_HEADER_SIZE + siglen;
+        return out;
+    }
+
+    const unsigned char *SignDataMerkle(CryptoContext *ctx, const unsigned char *data, unsigned long dataLen, unsigned int leafSize, int &signatureLen)
+    {
+        signatureLen = -1;
+
+        if (not ctx or not ctx->isSetForSigning())
+        {
+            return nullptr;
+        }
+
+        MerkleTree *tree = MerkleTree::Factory::create(data, dataLen, leafSize);
+        const unsigned char *signature = SignMerkleTree(ctx, tree, signatureLen);
+
+        delete tree;
+
+        return signature;
+    }
+
+    bool VerifyDataMerkle(CryptoContext *ctx, const unsigned char *data, unsigned long dataLen, const unsigned char *signature, unsigned int signatureLen)
+    {
+        unsigned int leafSize;
+        unsigned long signedDataLen;
+
+        if (not ctx or not ctx->isSetForVerifying() or not ReadHeader(signature, signatureLen, leafSize, signedDataLen) or signedDataLen != dataLen)
+        {
+            return false;
+        }
+
+        MerkleTree *tree = MerkleTree::Factory::create(data, dataLen, leafSize);
+        bool valid = tree and VerifyMerkleRoot(ctx, tree->getRoot(), signature, signatureLen);
+
+        delete tree;
+
+        return valid;
+    }
+
+    bool VerifyMerkleChunk(CryptoContext *ctx, const unsigned char *chunk, unsigned int chunkLen, unsigned long index,
+                           const unsigned char *proof, unsigned int proofLen, const unsigned char *signature, unsigned int signatureLen)
+    {
+        unsigned int leafSize;
+        unsigned long dataLen;
+
+        if (not ctx or not ReadHeader(signature, signatureLen, leafSize, dataLen) or (not chunk and chunkLen))
+        {
+            return false;
+        }
+
+        unsigned long leafCount = MerkleTree::getLeafCount(dataLen, leafSize);
+        unsigned long offset = index * leafSize;
+
+        // every leaf but the last one is exactly leafSize bytes;
+        if (index >= leafCount or chunkLen != (dataLen - offset < leafSize ? dataLen - offset : leafSize))
+        {
+            return false;
+        }
+
+        unsigned char leafHash[MERKLE_HASH_SIZE];
+        unsigned char root[MERKLE_HASH_SIZE];
+
+        return MerkleTree::hashLeaf(chunk, chunkLen, leafHash) and
+               MerkleTree::computeRoot(leafHash, index, leafCount, proof, proofLen, root) and
+               VerifyMerkleRoot(ctx, root, signature, signatureLen);
+    }
+
+    const unsigned char *SignBatch(CryptoContext *ctx, const unsigned char **messages, const unsigned int *messageLens, unsigned int count,
+                                   const unsigned char **signatures, unsigned int *signatureLens, int &totalLen)
+    {
+        totalLen = -1;
+
+        if (not ctx or not ctx->isSetForSigning() or not signatures or not signatureLens)
+        {
+            return nullptr;
+        }
+
+        MerkleTree *tree = MerkleTree::Factory::createFromMessages(messages, messageLens, count);
+
+        if (not tree)
+        {
+            return nullptr;
+        }
+
+        unsigned char header[BATCH_SIGNATURE_HEADER_SIZE];
+        memcpy(header, BatchSignatureMagic, 4);
+        WriteBigEndian(header + 4, count, 8);
+        memcpy(header + 12, tree->getRoot(), MERKLE_HASH_SIZE);
+
+        int rootSignatureLen;
+        const unsigned char *rootSignature = SignDataDetached(ctx, header, BATCH_SIGNATURE_SIGNED_SIZE, rootSignatureLen);
+
+        if (not rootSignature)
+        {
+            delete tree;
+            return nullptr;
+        }
+
+        WriteBigEndian(header + BATCH_SIGNATURE_SIGNED_SIZE, rootSignatureLen, 4);
+
+        std::vector<std::vector<unsigned char>> proofs(count);
+        unsigned long size = 0;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            tree->getProof(i, proofs[i]);
+            signatureLens[i] = BATCH_SIGNATURE_HEADER_SIZE + rootSignatureLen + BATCH_SIGNATURE_INDEX_SIZE + proofs[i].size();
+            size += signatureLens[i];
+        }
+
+        delete tree;
+
+        unsigned char *out = new unsigned char[size + 1];
+        unsigned char *signature = out;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            signatures[i] = signature;
+
+            memcpy(signature, header, BATCH_SIGNATURE_HEADER_SIZE);
+            memcpy(signature + BATCH_SIGNATURE_HEADER_SIZE, rootSignature, rootSignatureLen);
+            signature += BATCH_SIGNATURE_HEADER_SIZE + rootSignatureLen;
+
+            WriteBigEndian(signature, i, BATCH_SIGNATURE_INDEX_SIZE);
+            memcpy(signature + BATCH_SIGNATURE_INDEX_SIZE, proofs[i].data(), proofs[i].size());
+            signature += BATCH_SIGNATURE_INDEX_SIZE + proofs[i].size();
+        }
+
+        totalLen = size;
+        return out;
+    }
+
+    bool VerifyBatchSignature(CryptoContext *ctx, const unsigned char *message, unsigned int messageLen, const unsigned char *signature, unsigned int signatureLen)
+    {
+        if (not ctx or (not message and messageLen) or not signature or signatureLen < BATCH_SIGNATURE_HEADER_SIZE or
+            memcmp(signature, BatchSignatureMagic, 4) != 0)
+        {
+            return false;
+        }
+
+        unsigned long count = ReadBigEndian(signature + 4, 8);
+        unsigned long rootSignatureLen = ReadBigEndian(signature + BATCH_SIGNATURE_SIGNED_SIZE, 4);
+
+        if (signatureLen < BATCH_SIGNATURE_HEADER_SIZE + rootSignatureLen + BATCH_SIGNATURE_INDEX_SIZE)
+        {
+            return false;
+        }
+
+        const unsigned char *index = signature + BATCH_SIGNATURE_HEADER_SIZE + rootSignatureLen;
+        const unsigned char *proof = index + BATCH_SIGNATURE_INDEX_SIZE;
+        unsigned int proofLen = signature + signatureLen - proof;
+
+        unsigned char leafHash[MERKLE_HASH_SIZE];
+        unsigned char root[MERKLE_HASH_SIZE];
+
+        // the cheap inclusion proof is checked first, the root signature only once per batch;
+        return MerkleTree::hashLeaf(message, messageLen, leafHash) and
+               MerkleTree::computeRoot(leafHash, ReadBigEndian(index, BATCH_SIGNATURE_INDEX_SIZE), count, proof, proofLen, root) and
+               memcmp(root, signature + 12, MERKLE_HASH_SIZE) == 0 and
+               VerifyBatchRoot(ctx, signature, rootSignatureLen);
+    }
+}
@@ -0,0 +1,235 @@
+#include "cryptography/MerkleTree.hh"
+#include "cryptography/WorkerPool.hh"
+
+#include <atomic>
+#include <cstring>
+#include <openssl/evp.h>
+
+// leaves are hashed in tasks of at least this many bytes, so that small leaves do not flood the pool;
+#define MERKLE_TASK_SIZE 1048576
+#define MERKLE_MESSAGES_PER_TASK 64
+
+static const unsigned char LeafPrefix = 0;
+static const unsigned char NodePrefix = 1;
+
+static bool HashParts(EVP_MD_CTX *mdContext, unsigned char prefix, const unsigned char *first, unsigned int firstLen,
+                      const unsigned char *second, unsigned int secondLen, unsigned char *hash)
+{
+    unsigned int hashLen;
+
+    return mdContext and
+           EVP_DigestInit_ex(mdContext, EVP_sha256(), nullptr) == 1 and
+           EVP_DigestUpdate(mdContext, &prefix, 1) == 1 and
+           EVP_DigestUpdate(mdContext, first, firstLen) == 1 and
+           (not second or EVP_DigestUpdate(mdContext, second, secondLen) == 1) and
+           EVP_DigestFinal_ex(mdContext, hash, &hashLen) == 1;
+}
+
+bool MerkleTree::hashLeaf(const unsigned char *leaf, unsigned int leafLen, unsigned char *hash)
+{
+    EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+    bool ok = HashParts(mdContext, LeafPrefix, leaf, leafLen, nullptr, 0, hash);
+
+    EVP_MD_CTX_free(mdContext);
+
+    return ok;
+}
+
+bool MerkleTree::hashNode(const unsigned char *left, const unsigned char *right, unsigned char *hash)
+{
+    EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+    bool ok = HashParts(mdContext, NodePrefix, left, MERKLE_HASH_SIZE, right, MERKLE_HASH_SIZE, hash);
+
+    EVP_MD_CTX_free(mdContext);
+
+    return ok;
+}
+
+bool MerkleTree::hashLeaves(unsigned long leavesPerTask, const std::function<void(unsigned long, const unsigned char *&, unsigned int &)> &getLeaf)
+{
+    unsigned long taskCount = (this->leafCount + leavesPerTask - 1) / leavesPerTask;
+
+    this->levels.emplace_back(this->leafCount * MERKLE_HASH_SIZE);
+    unsigned char *hashes = this->levels.back().data();
+
+    std::atomic<bool> ok(true);
+
+    WorkerPool::getDefault()->run(taskCount, [&](unsigned int task)
+                                  {
+        EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+        unsigned long first = task * leavesPerTask;
+        unsigned long last = first + leavesPerTask < this->leafCount ? first + leavesPerTask : this->leafCount;
+
+        for (unsigned long i = first; i < last; i++)
+        {
+            const unsigned char *leaf;
+            unsigned int leafLen;
+
+            getLeaf(i, leaf, leafLen);
+
+            if (not HashParts(mdContext, LeafPrefix, leaf, leafLen, nullptr, 0, hashes + i * MERKLE_HASH_SIZE))
+            {
+                ok = false;
+            }
+        }
+
+        EVP_MD_CTX_free(mdContext); });
+
+    return ok;
+}
+
+bool MerkleTree::hashLevels()
+{
+    EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+    bool ok = mdContext != nullptr;
+
+    while (ok and this->levels.back().size() > MERKLE_HASH_SIZE)
+    {
+        const std::vector<unsigned char> &below = this->levels.back();
+        unsigned long count = below.size() / MERKLE_HASH_SIZE;
+        std::vector<unsigned char> level(((count + 1) / 2) * MERKLE_HASH_SIZE);
+
+        for (unsigned long i = 0; ok and i < count; i += 2)
+        {
+            if (i + 1 < count)
+            {
+                ok = HashParts(mdContext, NodePrefix, below.data() + i * MERKLE_HASH_SIZE, MERKLE_HASH_SIZE,
+                               below.data() + (i + 1) * MERKLE_HASH_SIZE, MERKLE_HASH_SIZE, level.data() + i / 2 * MERKLE_HASH_SIZE);
+            }
+            else
+            {
+                memcpy(level.data() + i / 2 * MERKLE_HASH_SIZE, below.data() + i * MERKLE_HASH_SIZE, MERKLE_HASH_SIZE);
+            }
+        }
+
+        this->levels.push_back(std::move(level));
+    }
+
+    EVP_MD_CTX_free(mdContext);
+
+    return ok;
+}
+
+bool MerkleTree::getProof(unsigned long index, std::vector<unsigned char> &proof) const
+{
+    proof.clear();
+
+    if (index >= this->getLeafCount())
+    {
+        return false;
+    }
+
+    for (unsigned int level = 0; level + 1 < this->levels.size(); level++, index /= 2)
+    {
+        unsigned long count = this->levels[level].size() / MERKLE_HASH_SIZE;
+        unsigned long sibling = index % 2 ? index - 1 : index + 1;
+
+        if (sibling < count)
+        {
+            const unsigned char *hash = this->levels[level].data() + sibling * MERKLE_HASH_SIZE;
+            proof.insert(proof.end(), hash, hash + MERKLE_HASH_SIZE);
+        }
+    }
+
+    return true;
+}
+
+bool MerkleTree::computeRoot(const unsigned char *leafHash, unsigned long index, unsigned long leafCount,
+                             const unsigned char *proof, unsigned int proofLen, unsigned char *root)
+{
+    if (not leafHash or not root or index >= leafCount or (proofLen and not proof))
+    {
+        return false;
+    }
+
+    unsigned char hash[MERKLE_HASH_SIZE];
+    unsigned int offset = 0;
+
+    memcpy(hash, leafHash, MERKLE_HASH_SIZE);
+
+    for (unsigned long count = leafCount; count > 1; count = (count + 1) / 2, index /= 2)
+    {
+        unsigned long sibling = index % 2 ? index - 1 : index + 1;
+
+        if (sibling >= count)
+        {
+            continue;
+        }
+
+        if (offset + MERKLE_HASH_SIZE > proofLen)
+        {
+            return false;
+        }
+
+        bool ok = index % 2 ? hashNode(proof + offset, hash, hash) : hashNode(hash, proof + offset, hash);
+
+        if (not ok)
+        {
+            return false;
+        }
+
+        offset += MERKLE_HASH_SIZE;
+    }
+
+    memcpy(root, hash, MERKLE_HASH_SIZE);
+
+    return offset == proofLen;
+}
+
+MerkleTree *MerkleTree::Factory::create(const unsigned char *data, unsigned long dataLen, unsigned int leafSize)
+{
+    if ((not data and dataLen) or not leafSize)
+    {
+        return nullptr;
+    }
+
+    MerkleTree *tree = new MerkleTree(leafSize, dataLen, getLeafCount(dataLen, leafSize));
+    unsigned long leavesPerTask = leafSize < MERKLE_TASK_SIZE ? MERKLE_TASK_SIZE / leafSize : 1;
+
+    bool ok = tree->hashLeaves(leavesPerTask, [&](unsigned long i, const unsigned char *&leaf, unsigned int &leafLen)
+                               {
+        unsigned long offset = i * leafSize;
+
+        leaf = data + offset;
+        leafLen = dataLen - offset < leafSize ? dataLen - offset : leafSize; });
+
+    if (not ok or not tree->hashLevels())
+    {
+        delete tree;
+        return nullptr;
+    }
+
+    return tree;
+}
+
+MerkleTree *MerkleTree::Factory::createFromMessages(const unsigned char **messages, const unsigned int *messageLens, unsigned long count)
+{
+    if (not messages or not messageLens or not count)
+    {
+        return nullptr;
+    }
+
+    for (unsigned long i = 0; i < count; i++)
+    {
+        if (not messages[i] and messageLens[i])
+        {
+            return nullptr;
+        }
+    }
+
+    MerkleTree *tree = new MerkleTree(0, 0, count);
+
+    // messages are expected to be small, so each task hashes a block of them;
+    bool ok = tree->hashLeaves(MERKLE_MESSAGES_PER_TASK, [&](unsigned long i, const unsigned char *&leaf, unsigned int &leafLen)
+                               {
+        leaf = messages[i];
+        leafLen = messageLens[i]; });
+
+    if (not ok or not tree->hashLevels())
+    {
+        delete tree;
+        return nullptr;
+    }
+
+    return tree;
+}
@@ -1,120 +1,49 @@
-#include <cstring>
-#include <iostream>
+#include "cryptography/OnionBuilding.hh"
 
-#include "cryptography/Factories.hh"
-#include "cryptography/Utils.hh"
-#include "cryptography/Constants.hh"
-#include "cryptography/Encryption.hh"
-
-static void sha256HexToBytes(const char *sha246Hex, unsigned char *out)
+static const unsigned char *SealOnionOnce(OnionRoute *route, const unsigned char *plaintext, unsigned int plaintextLen, OnionFormat format, int &outLen)
 {
-    char *buffer = new char[3];
-    buffer[2] = 0;
-
-    unsigned int stringSize = 2 * ADDRESS_SIZE;
+    outLen = -1;
 
-    for (int i = 0; i < stringSize; i += 2)
+    if (not route)
     {
-        memcpy(buffer, sha246Hex + i, 2);
-        out[i / 2] = static_cast<unsigned char>(std::stoi(buffer, nullptr, 16));
+        return nullptr;
     }
 
-    delete[] buffer;
-}
+    const unsigned char *onion = route->seal(plaintext, plaintextLen, outLen, format);
 
-static void EncodeOnionSize(unsigned int size, unsigned char *out)
-{
-    out[0] = size / 256;
-    out[1] = size % 256;
+    delete route;
+
+    return onion;
 }
 
-static void SealOnionRecursive(unsigned char *data, int &len, CryptoContext **ctx, const char **addresses, int i, unsigned int count)
+extern "C"
 {
-    memcpy(data + ADDRESS_SIZE, data, len);
-    sha256HexToBytes(addresses[i], data);
-
-    const EncrypterResult *result = EncryptDataEx(ctx[i], data, len + ADDRESS_SIZE);
-
-    if (result->isError())
+    const unsigned char *SealOnion(const unsigned char *plaintext, unsigned int plaintextLen, const char **keys, const char **addresses, unsigned int count, int &outLen)
     {
-        len = -1;
-        return;
+        return SealOnionOnce(OnionRoute::Factory::create(keys, addresses, count), plaintext, plaintextLen, OnionFormatV1, outLen);
     }
 
-    int encryptionSize = result->getDataSize();
-    len = encryptionSize + ONION_LENGTH_BYTES;
-
-    memcpy(data + ONION_LENGTH_BYTES, result->getData(), encryptionSize);
-    EncodeOnionSize(encryptionSize, data);
-
-    if (i == count - 1)
-    {
-        return;
-    }
-    else
+    const unsigned char *SealOnionWithFormat(const unsigned char *plaintext, unsigned int plaintextLen, const char **keys, const char **addresses, unsigned int count, OnionFormat format, int &outLen)
     {
-        SealOnionRecursive(data, len, ctx, addresses, i + 1, count);
+        return SealOnionOnce(OnionRoute::Factory::create(keys, addresses, count), plaintext, plaintextLen, format, outLen);
     }
-}
-
-static CryptoContext **AllocateStructuresAndCalculateTotalSize(unsigned int plaintextLen, const char **keys, const char **addresses, unsigned int count, int &allocatedIterations, unsigned char **outputBuffer)
-{
-    CryptoContext **ctx = new CryptoContext *[count];
-    unsigned int requiredMemory = plaintextLen;
 
-    for (allocatedIterations = 0; allocatedIterations < count; allocatedIterations++)
+    const unsigned char *SealOnionWithKeyDirectory(const unsigned char *plaintext, unsigned int plaintextLen, KeyDirectory *directory, const char **addresses, unsigned int count, int &outLen)
     {
-        requiredMemory = GetEnvelopeSize(requiredMemory + ADDRESS_SIZE) + ONION_LENGTH_BYTES;
-
-        if (not keys[allocatedIterations] or not addresses[allocatedIterations] or
-            not(ctx[allocatedIterations] = CreateAsymmetricEncryptionContext(keys[allocatedIterations])))
-        {
-            break;
-        }
+        return SealOnionOnce(OnionRoute::Factory::createFromKeyDirectory(directory, addresses, count), plaintext, plaintextLen, OnionFormatV1, outLen);
     }
 
-    if (allocatedIterations == count)
+    const unsigned char *SealOnionWithRoute(OnionRoute *route, const unsigned char *plaintext, unsigned int plaintextLen, int &outLen)
     {
-        *outputBuffer = new unsigned char[requiredMemory + 1];
-    }
-
-    return ctx;
-}
+        outLen = -1;
 
-static void FreeStructures(CryptoContext **ctx, unsigned int allocatedIterations)
-{
-    for (int i = 0; i < allocatedIterations; i++)
-    {
-        FreeContext(ctx[i]);
+        return route ? route->seal(plaintext, plaintextLen, outLen) : nullptr;
     }
 
-    delete[] ctx;
-}
-
-extern "C" const unsigned char *SealOnion(const unsigned char *plaintext, unsigned int plaintextLen, const char **keys, const char **addresses, unsigned int count, int &outLen)
-{
-    // required memory to hold the final onion
-    unsigned char *output = nullptr;
-
-    /*
-     * keeps track of how many CryptoContext structures have been allocated;
-     * there is a chance this number to be smaller than required, i.e. partial allocation (in case of invalid keys, for example);
-     * we need to know how many have been allocated in order to release memory afterwards;
-     */
-    int allocatedIterations;
-
-    CryptoContext **ctx = AllocateStructuresAndCalculateTotalSize(plaintextLen, keys, addresses, count, allocatedIterations, &output);
-    outLen = -1;
-
-    if (allocatedIterations == count)
+    const unsigned char *SealOnionWithRouteAndFormat(OnionRoute *route, const unsigned char *plaintext, unsigned int plaintextLen, OnionFormat format, int &outLen)
     {
-        memcpy(output, plaintext, plaintextLen);
-        outLen = plaintextLen;
+        outLen = -1;
 
-        SealOnionRecursive(output, outLen, ctx, addresses, 0, count);
+        return route ? route->seal(plaintext, plaintextLen, outLen, format) : nullptr;
     }
-
-    FreeStructures(ctx, allocatedIterations);
-
-    return output;
 }
@@ -1,7 +1,18 @@
+#include "cryptography/OnionParsing.hh"
 #include "cryptography/Encryption.hh"
 #include "cryptography/Constants.hh"
 
-#include <pthread.h>
+static unsigned int DecodeBigEndian(const unsigned char *in, unsigned int size)
+{
+    unsigned int value = 0;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        value = (value << 8) | in[i];
+    }
+
+    return value;
+}
 
 extern "C"
 {
@@ -12,13 +23,7 @@ extern "C"
             return 0;
         }
 
-        unsigned int size = 0;
-        for (int i = 0; i < ONION_LENGTH_BYTES; i++)
-        {
-            size += onion[i] * pow(256, ONION_LENGTH_BYTES - i - 1);
-        }
-
-        return size;
+        return DecodeBigEndian(onion, ONION_LENGTH_BYTES);
     }
 
     const unsigned char *UnsealOnion(CryptoContext *ctx, const unsigned char *onion, int &plaintextLen)
@@ -34,4 +39,38 @@ extern "C"
 
         return DecryptData(ctx, ciphertext, cipherLen, plaintextLen);
     }
+
+    unsigned int GetOnionHeaderSize(OnionFormat format)
+    {
+        return format == OnionFormatV2 ? 1 + ONION_V2_LENGTH_BYTES : ONION_LENGTH_BYTES;
+    }
+
+    unsigned int DecodeOnionLayerSize(const unsigned char *onion, unsigned int onionLen, OnionFormat format)
+    {
+        unsigned int headerSize = GetOnionHeaderSize(format);
+
+        if (not onion or onionLen < headerSize or (format == OnionFormatV2 and onion[0] != ONION_V2_VERSION))
+        {
+            return 0;
+        }
+
+        unsigned int size = format == OnionFormatV2 ? DecodeBigEndian(onion + 1, ONION_V2_LENGTH_BYTES)
+                                                    : DecodeBigEndian(onion, ONION_LENGTH_BYTES);
+
+        return size <= onionLen - headerSize ? size : 0;
+    }
+
+    const unsigned char *UnsealOnionWithFormat(CryptoContext *ctx, const unsigned char *onion, unsigned int onionLen, OnionFormat format, int &plaintextLen)
+    {
+        unsigned int cipherLen = DecodeOnionLayerSize(onion, onionLen, format);
+
+        plaintextLen = -1;
+
+        if (not ctx or not cipherLen)
+        {
+            return nullptr;
+        }
+
+        return DecryptData(ctx, onion + GetOnionHeaderSize(format), cipherLen, plaintextLen);
+    }
 }
@@ -0,0 +1,287 @@
+#include "cryptography/OnionRoute.hh"
+#include "cryptography/Factories.hh"
+#include "cryptography/Utils.hh"
+
+#include <cctype>
+#include <climits>
+#include <cstring>
+
+// the size of every layer must fit in the length field of its header;
+#define ONION_MAX_LAYER_SIZE ((1u << (8 * ONION_LENGTH_BYTES)) - 1)
+
+static void EncodeBigEndian(unsigned int value, unsigned int size, unsigned char *out)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        out[size - 1 - i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static bool EncodeOnionHeader(unsigned int size, OnionFormat format, unsigned char *out)
+{
+    if (format == OnionFormatV2)
+    {
+        out[0] = ONION_V2_VERSION;
+        EncodeBigEndian(size, ONION_V2_LENGTH_BYTES, out + 1);
+        return true;
+    }
+
+    if (size > ONION_MAX_LAYER_SIZE)
+    {
+        return false;
+    }
+
+    EncodeBigEndian(size, ONION_LENGTH_BYTES, out);
+    return true;
+}
+
+static unsigned char HexDigitValue(char digit)
+{
+    return isdigit((unsigned char)digit) ? digit - '0' : tolower((unsigned char)digit) - 'a' + 10;
+}
+
+OnionRoute::~OnionRoute()
+{
+    for (Hop &hop : this->hops)
+    {
+        FreeContext(hop.ctx);
+    }
+}
+
+bool OnionRoute::addHop(CryptoContext *ctx, const unsigned char *address)
+{
+    unsigned int envelopeSize = GetContextEnvelopeSize(ctx, 0);
+
+    if (not envelopeSize or not address)
+    {
+        FreeContext(ctx);
+        return false;
+    }
+
+    Hop hop;
+    hop.ctx = ctx;
+    hop.keySize = ctx->getKeySize();
+    memcpy(hop.address, address, ADDRESS_SIZE);
+
+    this->hops.push_back(hop);
+    this->overhead += envelopeSize + ADDRESS_SIZE;
+    this->headerSize += hop.keySize + IV_SIZE + ADDRESS_SIZE;
+
+    return true;
+}
+
+unsigned int OnionRoute::getOnionSize(unsigned int plaintextLen, OnionFormat format) const
+{
+    unsigned long size = plaintextLen + this->overhead + this->hops.size() * GetOnionHeaderSize(format);
+
+    return size <= INT_MAX ? size : 0;
+}
+
+bool OnionRoute::sealLayers(unsigned char *onion, unsigned int plaintextLen, OnionFormat format)
+{
+    /*
+     * every layer is laid out around the one it wraps, so that nothing is ever moved or copied:
+     * | length | encrypted key | IV | address | inner layer | tag |
+     * the header of the outermost layer comes first, the tag of the outermost layer last;
+     */
+    unsigned int layerHeaderSize = GetOnionHeaderSize(format);
+    unsigned long start = this->getHeaderSize(format);
+    unsigned int innerLen = plaintextLen;
+
+    for (Hop &hop : this->hops)
+    {
+        start -= layerHeaderSize + hop.keySize + IV_SIZE + ADDRESS_SIZE;
+
+        unsigned char *layer = onion + start;
+        unsigned int contentLen = ADDRESS_SIZE + innerLen;
+        unsigned int envelopeLen = hop.keySize + IV_SIZE + contentLen + TAG_SIZE;
+
+        if (not EncodeOnionHeader(envelopeLen, format, layer))
+        {
+            return false;
+        }
+
+        memcpy(layer + layerHeaderSize + hop.keySize + IV_SIZE, hop.address, ADDRESS_SIZE);
+
+        if (not hop.ctx->sealEnvelopeInPlace(layer + layerHeaderSize, contentLen))
+        {
+            return false;
+        }
+
+        innerLen = layerHeaderSize + envelopeLen;
+    }
+
+    return true;
+}
+
+const unsigned char *OnionRoute::seal(const unsigned char *plaintext, unsigned int plaintextLen, int &outLen, OnionFormat format)
+{
+    // exact size, derived from the actual size of every hop key; the payload is the only copy made;
+    unsigned int onionSize = this->getOnionSize(plaintextLen, format);
+
+    outLen = -1;
+
+    if (not plaintext or not onionSize)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    unsigned char *output = new unsigned char[onionSize + 1];
+
+    memcpy(output + this->getHeaderSize(format), plaintext, plaintextLen);
+
+    if (not this->sealLayers(output, plaintextLen, format))
+    {
+        delete[] output;
+        return nullptr;
+    }
+
+    outLen = onionSize;
+
+    return output;
+}
+
+OnionRoute *OnionRoute::clone() const
+{
+    OnionRoute *route = new OnionRoute();
+
+    for (const Hop &hop : this->hops)
+    {
+        const AsymmetricKey *key = static_cast<const AsymmetricKey *>(hop.ctx->getKey());
+
+        if (not route->addHop(CreateAsymmetricEncryptionContextFromKey(key), hop.address))
+        {
+            delete route;
+            return nullptr;
+        }
+    }
+
+    return route;
+}
+
+bool OnionRoute::decodeAddress(const char *hexAddress, unsigned char *address)
+{
+    if (not hexAddress or not address)
+    {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < 2 * ADDRESS_SIZE; i++)
+    {
+        if (not isxdigit((unsigned char)hexAddress[i]))
+        {
+            return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < ADDRESS_SIZE; i++)
+    {
+        address[i] = HexDigitValue(hexAddress[2 * i]) << 4 | HexDigitValue(hexAddress[2 * i + 1]);
+    }
+
+    return true;
+}
+
+OnionRoute *OnionRoute::Factory::create(const char **keys, const char **addresses, unsigned int count)
+{
+    if (not keys or not addresses or not count)
+    {
+        return nullptr;
+    }
+
+    OnionRoute *route = new OnionRoute();
+    unsigned char address[ADDRESS_SIZE];
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (not keys[i] or not decodeAddress(addresses[i], address) or
+            not route->addHop(CreateAsymmetricEncryptionContext(keys[i]), address))
+        {
+            delete route;
+            return nullptr;
+        }
+    }
+
+    return route;
+}
+
+OnionRoute *OnionRoute::Factory::createFromKeys(const AsymmetricKey **keys, const unsigned char **addresses, unsigned int count)
+{
+    if (not keys or not addresses or not count)
+    {
+        return nullptr;
+    }
+
+    OnionRoute *route = new OnionRoute();
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (not route->addHop(CreateAsymmetricEncryptionContextFromKey(keys[i]), addresses[i]))
+        {
+            delete route;
+            return nullptr;
+        }
+    }
+
+    return route;
+}
+
+OnionRoute *OnionRoute::Factory::createFromKeyDirectory(KeyDirectory *directory, const char **addresses, unsigned int count)
+{
+    if (not directory or not addresses or not count)
+    {
+        return nullptr;
+    }
+
+    OnionRoute *route = new OnionRoute();
+    unsigned char address[ADDRESS_SIZE];
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        // contexts share the key parsed by the directory;
+        const AsymmetricKey *key = decodeAddress(addresses[i], address) ? directory->getKey(address) : nullptr;
+
+        if (not key or not route->addHop(CreateAsymmetricEncryptionContextFromKey(key), address))
+        {
+            delete route;
+            return nullptr;
+        }
+    }
+
+    return route;
+}
+
+extern "C"
+{
+    OnionRoute *CreateOnionRoute(const char **keys, const char **addresses, unsigned int count)
+    {
+        return OnionRoute::Factory::create(keys, addresses, count);
+    }
+
+    OnionRoute *CreateOnionRouteFromKeyDirectory(KeyDirectory *directory, const char **addresses, unsigned int count)
+    {
+        return OnionRoute::Factory::createFromKeyDirectory(directory, addresses, count);
+    }
+
+    OnionRoute *CloneOnionRoute(const OnionRoute *route)
+    {
+        return route ? route->clone() : nullptr;
+    }
+
+    void FreeOnionRoute(OnionRoute *route)
+    {
+        delete route;
+    }
+
+    unsigned int GetOnionRouteSize(const OnionRoute *route, unsigned int plaintextLen)
+    {
+        return route ? route->getOnionSize(plaintextLen) : 0;
+    }
+
+    unsigned int GetOnionRouteSizeWithFormat(const OnionRoute *route, unsigned int plaintextLen, OnionFormat format)
+    {
+        return route ? route->getOnionSize(plaintextLen, format) : 0;
+    }
+}
@@ -0,0 +1,228 @@
+#include "cryptography/Signatures.hh"
+#include "cryptography/EvpMdContext.hh"
+#include "cryptography/MappedFile.hh"
+
+static EvpMdContext *GetSigningCipher(CryptoContext *ctx)
+{
+    return ctx and ctx->isSetForSigning() ? ctx->getSignatureCipher() : nullptr;
+}
+
+static EvpMdContext *GetVerificationCipher(CryptoContext *ctx)
+{
+    return ctx and ctx->isSetForVerifying() ? ctx->getSignatureCipher() : nullptr;
+}
+
+template <typename Update>
+static bool ReadFileInChunks(const char *path, Update update)
+{
+    MappedFile *file = MappedFile::Factory::create(path);
+
+    if (not file)
+    {
+        return false;
+    }
+
+    // chunks are handed out straight from the mapping; nothing is copied;
+    bool ok = true;
+
+    for (unsigned long offset = 0; ok and offset < file->getSize(); offset += STREAM_CHUNK_SIZE)
+    {
+        unsigned long len = file->getSize() - offset < STREAM_CHUNK_SIZE ? file->getSize() - offset : STREAM_CHUNK_SIZE;
+        ok = update(file->getData() + offset, len);
+    }
+
+    delete file;
+
+    return ok;
+}
+
+extern "C"
+{
+    const unsigned char *SignDataDetached(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen, int &signatureLen)
+    {
+        EvpMdContext *cipher = GetSigningCipher(ctx);
+        unsigned int siglen = 0;
+        const unsigned char *signature = cipher ? cipher->signDetached(data, dataLen, siglen) : nullptr;
+
+        signatureLen = signature ? siglen : -1;
+        return signature;
+    }
+
+    bool VerifyDetachedSignature(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen, const unsigned char *signature, unsigned int signatureLen)
+    {
+        EvpMdContext *cipher = GetVerificationCipher(ctx);
+
+        return cipher and cipher->verifyDetached(data, dataLen, signature, signatureLen);
+    }
+
+    bool ComputeSignatureDigest(const unsigned char *data, unsigned int dataLen, unsigned char *digest)
+    {
+        unsigned int digestLen;
+
+        return data and digest and EVP_Digest(data, dataLen, digest, &digestLen, EVP_sha256(), nullptr) == 1;
+    }
+
+    bool ComputeFileSignatureDigest(const char *path, unsigned char *digest)
+    {
+        if (not path or not digest)
+        {
+            return false;
+        }
+
+        EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+        unsigned int digestLen;
+
+        bool ok = mdContext and EVP_DigestInit_ex(mdContext, EVP_sha256(), nullptr) == 1 and
+                  ReadFileInChunks(path, [mdContext](const unsigned char *chunk, unsigned int len)
+                                   { return EVP_DigestUpdate(mdContext, chunk, len) == 1; }) and
+                  EVP_DigestFinal_ex(mdContext, digest, &digestLen) == 1;
+
+        EVP_MD_CTX_free(mdContext);
+
+        return ok;
+    }
+
+    bool ComputeTypedSignatureDigest(DigestType digestType, const unsigned char *data, unsigned int dataLen, unsigned char *digest)
+    {
+        unsigned int digestLen;
+
+        return data and digest and EVP_Digest(data, dataLen, digest, &digestLen, EvpMdContext::getDigestByType(digestType), nullptr) == 1;
+    }
+
+    unsigned int GetSignatureDigestSize(DigestType digestType)
+    {
+        return EVP_MD_get_size(EvpMdContext::getDigestByType(digestType));
+    }
+
+    const unsigned char *SignDigest(CryptoContext *ctx, const unsigned char *digest, unsigned int digestLen, int &signatureLen)
+    {
+        EvpMdContext *cipher = GetSigningCipher(ctx);
+        unsigned int siglen = 0;
+        const unsigned char *signature = cipher ? cipher->signDigest(digest, digestLen, siglen) : nullptr;
+
+        signatureLen = signature ? siglen : -1;
+        return signature;
+    }
+
+    bool VerifyDigestSignature(CryptoContext *ctx, const unsigned char *digest, unsigned int digestLen, const unsigned char *signature, unsigned int signatureLen)
+    {
+        EvpMdContext *cipher = GetVerificationCipher(ctx);
+
+        return cipher and cipher->verifyDigest(digest, digestLen, signature, signatureLen);
+    }
+
+    bool SignInit(CryptoContext *ctx)
+    {
+        EvpMdContext *cipher = GetSigningCipher(ctx);
+
+        return cipher and cipher->signInit();
+    }
+
+    bool SignUpdate(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen)
+    {
+        EvpMdContext *cipher = GetSigningCipher(ctx);
+
+        return cipher and cipher->signUpdate(data, dataLen);
+    }
+
+    const unsigned char *SignFinal(CryptoContext *ctx, int &signatureLen)
+    {
+        EvpMdContext *cipher = GetSigningCipher(ctx);
+        unsigned int siglen = 0;
+        const unsigned char *signature = cipher ? cipher->signFinal(siglen) : nullptr;
+
+        signatureLen = signature ? siglen : -1;
+        return signature;
+    }
+
+    bool VerifyInit(CryptoContext *ctx)
+    {
+        EvpMdContext *cipher = GetVerificationCipher(ctx);
+
+        return cipher and cipher->verifyInit();
+    }
+
+    bool VerifyUpdate(CryptoContext *ctx, const unsigned char *data, unsigned int dataLen)
+    {
+        EvpMdContext *cipher = GetVerificationCipher(ctx);
+
+        return cipher and cipher->verifyUpdate(data, dataLen);
+    }
+
+    bool VerifyFinal(CryptoContext *ctx, const unsigned char *signature, unsigned int signatureLen)
+    {
+        EvpMdContext *cipher = GetVerificationCipher(ctx);
+
+        return cipher and cipher->verifyFinal(signature, signatureLen);
+    }
+
+    const unsigned char *SignFile(CryptoContext *ctx, const char *path, int &signatureLen)
+    {
+        signatureLen = -1;
+
+        if (not path or not SignInit(ctx))
+        {
+            return nullptr;
+        }
+
+        bool ok = ReadFileInChunks(path, [ctx](const unsigned char *chunk, unsigned int len)
+                                   { return SignUpdate(ctx, chunk, len); });
+
+        if (not ok)
+        {
+            ctx->getSignatureCipher()->cleanup();
+            return nullptr;
+        }
+
+        return SignFinal(ctx, signatureLen);
+    }
+
+    bool VerifyFileSignature(CryptoContext *ctx, const char *path, const unsigned char *signature, unsigned int signatureLen)
+    {
+        if (not path or not VerifyInit(ctx))
+        {
+            return false;
+        }
+
+        bool ok = ReadFileInChunks(path, [ctx](const unsigned char *chunk, unsigned int len)
+                                   { return VerifyUpdate(ctx, chunk, len); });
+
+        if (not ok)
+        {
+            ctx->getSignatureCipher()->cleanup();
+            return false;
+        }
+
+        return VerifyFinal(ctx, signature, signatureLen);
+    }
+
+    VerificationCache *CreateVerificationCache(unsigned int capacity, unsigned int ttlSeconds)
+    {
+        return new VerificationCache(capacity, ttlSeconds);
+    }
+
+    void FreeVerificationCache(VerificationCache *cache)
+    {
+        if (cache != VerificationCache::getShared())
+        {
+            delete cache;
+        }
+    }
+
+    VerificationCache *GetSharedVerificationCache()
+    {
+        return VerificationCache::getShared();
+    }
+
+    bool SetVerificationCache(CryptoContext *ctx, VerificationCache *cache)
+    {
+        return ctx and ctx->setVerificationCache(cache);
+    }
+
+    void GetVerificationCacheStats(VerificationCache *cache, unsigned long &hits, unsigned long &misses, unsigned int &size)
+    {
+        hits = cache ? cache->getHits() : 0;
+        misses = cache ? cache->getMisses() : 0;
+        size = cache ? cache->getSize() : 0;
+    }
+}
@@ -0,0 +1,250 @@
+#include "cryptography/Signcryption.hh"
+#include "cryptography/Constants.hh"
+#include "cryptography/EvpMdContext.hh"
+
+#include <cstring>
+#include <openssl/evp.h>
+
+// a reference is taken, so the key survives a rotation of its handle during the operation;
+static EVP_PKEY *AcquireContextPKey(const CryptoContext *ctx)
+{
+    const Key *key = ctx->getKey();
+
+    return key and not key->isSymmetricKey() ? static_cast<const AsymmetricKey *>(key)->acquire() : nullptr;
+}
+
+static bool IsPureSignatureKey(EVP_PKEY *pkey)
+{
+    int id = EVP_PKEY_get_base_id(pkey);
+
+    return id == EVP_PKEY_ED25519 or id == EVP_PKEY_ED448;
+}
+
+static unsigned int GetChunkSize(unsigned int offset, unsigned int size)
+{
+    return size - offset < STREAM_CHUNK_SIZE ? size - offset : STREAM_CHUNK_SIZE;
+}
+
+static void FreeBuffer(unsigned char *buffer, unsigned int size)
+{
+    if (buffer)
+    {
+        memset(buffer, 0, size);
+        delete[] buffer;
+    }
+}
+
+static const EVP_MD *GetContextDigest(const CryptoContext *ctx)
+{
+    const EvpMdContext *cipher = ctx->getSignatureCipher();
+
+    return cipher ? cipher->getDigest() : nullptr;
+}
+
+static bool SignAndSealInternal(EVP_MD_CTX *mdContext, EVP_CIPHER_CTX *cipherContext, EVP_PKEY *signingKey, const EVP_MD *md, EVP_PKEY *sealingKey,
+                                const unsigned char *plaintext, unsigned int plaintextLen, unsigned char *envelope, unsigned int envelopeLen)
+{
+    int N = EVP_PKEY_size(sealingKey);
+    unsigned int S = EVP_PKEY_size(signingKey);
+
+    // encrypted key and IV are written straight into their final place inside the envelope;
+    unsigned char *encryptedKey = envelope;
+    int encryptedKeyLength;
+    unsigned char *iv = envelope + N;
+    unsigned char *ciphertext = iv + IV_SIZE;
+
+    if (EVP_SealInit(cipherContext, EVP_aes_256_gcm(), &encryptedKey, &encryptedKeyLength, iv, &sealingKey, 1) != 1 or encryptedKeyLength != N)
+    {
+        return false;
+    }
+
+    // Ed25519 signs the whole message at once, so its signature cannot be computed chunk by chunk;
+    bool streaming = not IsPureSignatureKey(signingKey);
+
+    if (EVP_DigestSignInit(mdContext, nullptr, streaming ? md : nullptr, nullptr, signingKey) != 1)
+    {
+        return false;
+    }
+
+    // each chunk is digested and encrypted while it is still hot in cache;
+    int outlen = 0;
+    int len;
+
+    for (unsigned int offset = 0; offset < plaintextLen; offset += STREAM_CHUNK_SIZE)
+    {
+        unsigned int chunkSize = GetChunkSize(offset, plaintextLen);
+
+        if ((streaming and EVP_DigestSignUpdate(mdContext, plaintext + offset, chunkSize) != 1) or
+            EVP_SealUpdate(cipherContext, ciphertext + outlen, &len, plaintext + offset, chunkSize) != 1)
+        {
+            return false;
+        }
+
+        outlen += len;
+    }
+
+    unsigned char *signature = new unsigned char[S + 1];
+    size_t siglen = S;
+
+    bool ok = (streaming ? EVP_DigestSignFinal(mdContext, signature, &siglen) : EVP_DigestSign(mdContext, signature, &siglen, plaintext, plaintextLen)) == 1 and
+              siglen == S and
+              EVP_SealUpdate(cipherContext, ciphertext + outlen, &len, signature, siglen) == 1;
+
+    FreeBuffer(signature, S);
+
+    if (not ok)
+    {
+        return false;
+    }
+
+    outlen += len;
+
+    if (EVP_SealFinal(cipherContext, ciphertext + outlen, &len) != 1)
+    {
+        return false;
+    }
+
+    outlen += len;
+
+    return EVP_CIPHER_CTX_ctrl(cipherContext, EVP_CTRL_GCM_GET_TAG, TAG_SIZE, ciphertext + outlen) == 1 and
+           outlen >= 0 and N + IV_SIZE + (unsigned int)outlen + TAG_SIZE == envelopeLen;
+}
+
+static bool OpenAndVerifyInternal(EVP_MD_CTX *mdContext, EVP_CIPHER_CTX *cipherContext, EVP_PKEY *openingKey, EVP_PKEY *verificationKey, const EVP_MD *md,
+                                  const unsigned char *envelope, unsigned int envelopeLen, unsigned char *plaintext, unsigned int plaintextLen)
+{
+    unsigned int N = EVP_PKEY_size(openingKey);
+    unsigned int S = EVP_PKEY_size(verificationKey);
+
+    const unsigned char *iv = envelope + N;
+    const unsigned char *ciphertext = iv + IV_SIZE;
+    const unsigned char *tag = envelope + envelopeLen - TAG_SIZE;
+
+    if (EVP_OpenInit(cipherContext, EVP_aes_256_gcm(), envelope, N, iv, openingKey) != 1)
+    {
+        return false;
+    }
+
+    bool streaming = not IsPureSignatureKey(verificationKey);
+
+    if (EVP_DigestVerifyInit(mdContext, nullptr, streaming ? md : nullptr, nullptr, verificationKey) != 1)
+    {
+        return false;
+    }
+
+    int len;
+
+    for (unsigned int offset = 0; offset < plaintextLen; offset += STREAM_CHUNK_SIZE)
+    {
+        unsigned int chunkSize = GetChunkSize(offset, plaintextLen);
+
+        if (EVP_OpenUpdate(cipherContext, plaintext + offset, &len, ciphertext + offset, chunkSize) != 1 or
+            (streaming and EVP_DigestVerifyUpdate(mdContext, plaintext + offset, len) != 1))
+        {
+            return false;
+        }
+    }
+
+    unsigned char *signature = new unsigned char[S + 1];
+
+    bool ok = EVP_OpenUpdate(cipherContext, signature, &len, ciphertext + plaintextLen, S) == 1 and
+              EVP_CIPHER_CTX_ctrl(cipherContext, EVP_CTRL_GCM_SET_TAG, TAG_SIZE, (void *)tag) == 1 and
+              EVP_OpenFinal(cipherContext, signature + len, &len) == 1 and
+              (streaming ? EVP_DigestVerifyFinal(mdContext, signature, S) : EVP_DigestVerify(mdContext, signature, S, plaintext, plaintextLen)) == 1;
+
+    FreeBuffer(signature, S);
+
+    return ok;
+}
+
+extern "C"
+{
+    const unsigned char *SignAndSeal(CryptoContext *signatureCtx, CryptoContext *encryptionCtx, const unsigned char *plaintext, unsigned int plaintextLen, int &envelopeLen)
+    {
+        envelopeLen = -1;
+
+        if (not plaintext or not signatureCtx or not encryptionCtx or
+            not signatureCtx->isSetForSigning() or not encryptionCtx->isSetForEncryption())
+        {
+            return nullptr;
+        }
+
+        EVP_PKEY *signingKey = AcquireContextPKey(signatureCtx);
+        EVP_PKEY *sealingKey = AcquireContextPKey(encryptionCtx);
+
+        if (not signingKey or not sealingKey)
+        {
+            EVP_PKEY_free(signingKey);
+            EVP_PKEY_free(sealingKey);
+            return nullptr;
+        }
+
+        unsigned int size = EVP_PKEY_size(sealingKey) + IV_SIZE + plaintextLen + EVP_PKEY_size(signingKey) + TAG_SIZE;
+        unsigned char *envelope = new unsigned char[size + 1];
+
+        EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+        EVP_CIPHER_CTX *cipherContext = EVP_CIPHER_CTX_new();
+
+        bool ok = mdContext and cipherContext and
+                  SignAndSealInternal(mdContext, cipherContext, signingKey, GetContextDigest(signatureCtx), sealingKey, plaintext, plaintextLen, envelope, size);
+
+        EVP_MD_CTX_free(mdContext);
+        EVP_CIPHER_CTX_free(cipherContext);
+        EVP_PKEY_free(signingKey);
+        EVP_PKEY_free(sealingKey);
+
+        if (not ok)
+        {
+            FreeBuffer(envelope, size);
+            return nullptr;
+        }
+
+        envelopeLen = size;
+        return envelope;
+    }
+
+    const unsigned char *OpenAndVerify(CryptoContext *decryptionCtx, CryptoContext *verificationCtx, const unsigned char *envelope, unsigned int envelopeLen, int &plaintextLen)
+    {
+        plaintextLen = -1;
+
+        if (not envelope or not decryptionCtx or not verificationCtx or
+            not decryptionCtx->isSetForDecryption() or not verificationCtx->isSetForVerifying())
+        {
+            return nullptr;
+        }
+
+        EVP_PKEY *openingKey = AcquireContextPKey(decryptionCtx);
+        EVP_PKEY *verificationKey = AcquireContextPKey(verificationCtx);
+        unsigned int overhead = openingKey and verificationKey ? EVP_PKEY_size(openingKey) + IV_SIZE + EVP_PKEY_size(verificationKey) + TAG_SIZE : 0;
+
+        if (not overhead or envelopeLen < overhead)
+        {
+            EVP_PKEY_free(openingKey);
+            EVP_PKEY_free(verificationKey);
+            return nullptr;
+        }
+
+        unsigned int size = envelopeLen - overhead;
+        unsigned char *plaintext = new unsigned char[size + 1];
+
+        EVP_MD_CTX *mdContext = EVP_MD_CTX_new();
+        EVP_CIPHER_CTX *cipherContext = EVP_CIPHER_CTX_new();
+
+        bool ok = mdContext and cipherContext and
+                  OpenAndVerifyInternal(mdContext, cipherContext, openingKey, verificationKey, GetContextDigest(verificationCtx), envelope, envelopeLen, plaintext, size);
+
+        EVP_MD_CTX_free(mdContext);
+        EVP_CIPHER_CTX_free(cipherContext);
+        EVP_PKEY_free(openingKey);
+        EVP_PKEY_free(verificationKey);
+
+        if (not ok)
+        {
+            FreeBuffer(plaintext, size);
+            return nullptr;
+        }
+
+        plaintextLen = size;
+        return plaintext;
+    }
+}
@@ -1,5 +1,23 @@
+#include "cryptography/Utils.hh"
 #include "cryptography/Constants.hh"
 
+static unsigned int GetAsymmetricKeySize(const CryptoContext *ctx)
+{
+    if (not ctx or not ctx->getKey() or ctx->getKey()->isSymmetricKey())
+    {
+        return 0;
+    }
+
+    int size = ctx->getKeySize();
+
+    return size > 0 ? size : 0;
+}
+
+static unsigned int GetOnionLayerSize(unsigned int keySize, unsigned int innerSize)
+{
+    return keySize + IV_SIZE + ADDRESS_SIZE + innerSize + TAG_SIZE + ONION_LENGTH_BYTES;
+}
+
 extern "C"
 {
     unsigned int GetAesGcmCiphertextSize(unsigned int plaintext)
@@ -27,6 +45,11 @@ extern "C"
         return PKEY_SIZE / 8 + dataSize;
     }
 
+    unsigned int GetEd25519SignedDataSize(unsigned int dataSize)
+    {
+        return ED25519_SIGNATURE_SIZE + dataSize;
+    }
+
     unsigned int GetDefaultAddressSize()
     {
         return ADDRESS_SIZE;
@@ -36,4 +59,84 @@ extern "C"
     {
         return PKEY_SIZE;
     }
+
+    unsigned int GetContextPKeySize(const CryptoContext *ctx)
+    {
+        return GetAsymmetricKeySize(ctx) * 8;
+    }
+
+    unsigned int GetContextEnvelopeSize(const CryptoContext *ctx, unsigned int plaintextLen)
+    {
+        unsigned int N = GetAsymmetricKeySize(ctx);
+
+        return N ? N + IV_SIZE + TAG_SIZE + plaintextLen : 0;
+    }
+
+    unsigned int GetContextOpenEnvelopeSize(const CryptoContext *ctx, unsigned int envelopeSize)
+    {
+        unsigned int N = GetAsymmetricKeySize(ctx);
+
+        if (not N or envelopeSize < N + IV_SIZE + TAG_SIZE)
+        {
+            return 0;
+        }
+
+        return envelopeSize - N - IV_SIZE - TAG_SIZE;
+    }
+
+    unsigned int GetContextSignedDataSize(const CryptoContext *ctx, unsigned int dataSize)
+    {
+        unsigned int N = GetAsymmetricKeySize(ctx);
+
+        return N ? N + dataSize : 0;
+    }
+
+    unsigned int GetContextsOnionSize(unsigned int plaintextLen, CryptoContext **ctx, unsigned int count)
+    {
+        if (not ctx)
+        {
+            return 0;
+        }
+
+        unsigned int size = plaintextLen;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            unsigned int N = GetAsymmetricKeySize(ctx[i]);
+
+            if (not N)
+            {
+                return 0;
+            }
+
+            size = GetOnionLayerSize(N, size);
+        }
+
+        return size;
+    }
+
+    unsigned int GetOnionSize(unsigned int plaintextLen, const char **keys, unsigned int count)
+    {
+        if (not keys)
+        {
+            return 0;
+        }
+
+        unsigned int size = plaintextLen;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            AsymmetricKey *key = keys[i] ? AsymmetricKey::Factory::createPublicKeyFromPem(keys[i], strlen(keys[i])) : nullptr;
+
+            if (not key)
+            {
+                return 0;
+            }
+
+            size = GetOnionLayerSize(key->getSize(), size);
+            delete key;
+        }
+
+        return size;
+    }
 }
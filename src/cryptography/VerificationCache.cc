@@ -0,0 +1,90 @@
+#include "cryptography/VerificationCache.hh"
+
+VerificationCache::VerificationCache(unsigned int capacity, unsigned int ttlSeconds)
+{
+    this->capacity = capacity;
+    this->ttl = ttlSeconds ? Clock::duration(std::chrono::seconds(ttlSeconds)) : Clock::duration::max();
+    this->hits = 0;
+    this->misses = 0;
+    this->evictions = 0;
+}
+
+bool VerificationCache::contains(const unsigned char *digest)
+{
+    std::string key((const char *)digest, VERIFICATION_CACHE_DIGEST_SIZE);
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto entry = this->entries.find(key);
+
+    if (entry == this->entries.end())
+    {
+        this->misses++;
+        return false;
+    }
+
+    if (Clock::now() >= entry->second.expires)
+    {
+        this->erase(entry);
+        this->misses++;
+        return false;
+    }
+
+    this->usage.splice(this->usage.begin(), this->usage, entry->second.usage);
+    this->hits++;
+
+    return true;
+}
+
+void VerificationCache::insert(const unsigned char *digest)
+{
+    if (this->capacity == 0)
+    {
+        return;
+    }
+
+    std::string key((const char *)digest, VERIFICATION_CACHE_DIGEST_SIZE);
+    Clock::time_point now = Clock::now();
+    Clock::time_point expires = this->ttl < Clock::time_point::max() - now ? now + this->ttl : Clock::time_point::max();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto entry = this->entries.find(key);
+
+    if (entry != this->entries.end())
+    {
+        entry->second.expires = expires;
+        this->usage.splice(this->usage.begin(), this->usage, entry->second.usage);
+        return;
+    }
+
+    while (this->entries.size() >= this->capacity)
+    {
+        this->erase(this->entries.find(this->usage.back()));
+        this->evictions++;
+    }
+
+    this->usage.push_front(key);
+    this->entries[key] = {expires, this->usage.begin()};
+}
+
+void VerificationCache::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->entries.clear();
+    this->usage.clear();
+}
+
+unsigned int VerificationCache::getSize()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    return this->entries.size();
+}
+
+VerificationCache *VerificationCache::getShared()
+{
+    static VerificationCache cache(VERIFICATION_CACHE_DEFAULT_CAPACITY, VERIFICATION_CACHE_DEFAULT_TTL);
+
+    return &cache;
+}
@@ -0,0 +1,108 @@
+#include "cryptography/WorkerPool.hh"
+
+WorkerPool::WorkerPool(unsigned int threads)
+{
+    this->task = nullptr;
+    this->taskCount = 0;
+    this->nextTask = 0;
+    this->generation = 0;
+    this->activeWorkers = 0;
+    this->stopping = false;
+
+    for (unsigned int i = 0; i < threads; i++)
+    {
+        this->workers.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+
+    this->wakeup.notify_all();
+
+    for (std::thread &worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+void WorkerPool::drain(const std::function<void(unsigned int)> *task, unsigned int taskCount)
+{
+    // a worker woken up after the job it was notified for completed sees no task at all
+    // and must not claim indexes belonging to a subsequent job;
+    if (not task)
+    {
+        return;
+    }
+
+    for (unsigned int i = this->nextTask++; i < taskCount; i = this->nextTask++)
+    {
+        (*task)(i);
+    }
+}
+
+void WorkerPool::work()
+{
+    unsigned long seen = 0;
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (true)
+    {
+        this->wakeup.wait(lock, [&]
+                          { return this->stopping or this->generation != seen; });
+
+        if (this->stopping)
+        {
+            return;
+        }
+
+        seen = this->generation;
+        this->activeWorkers++;
+
+        const std::function<void(unsigned int)> *task = this->task;
+        unsigned int taskCount = this->taskCount;
+
+        lock.unlock();
+        this->drain(task, taskCount);
+        lock.lock();
+
+        if (--this->activeWorkers == 0)
+        {
+            this->finished.notify_all();
+        }
+    }
+}
+
+void WorkerPool::run(unsigned int count, const std::function<void(unsigned int)> &task)
+{
+    std::lock_guard<std::mutex> runLock(this->runMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = &task;
+        this->taskCount = count;
+        this->nextTask = 0;
+        this->generation++;
+    }
+
+    this->wakeup.notify_all();
+    this->drain(&task, count);
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->finished.wait(lock, [&]
+                        { return this->activeWorkers == 0; });
+
+    this->task = nullptr;
+    this->taskCount = 0;
+}
+
+WorkerPool *WorkerPool::getDefault()
+{
+    static WorkerPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1);
+
+    return &pool;
+}
@@ -0,0 +1,165 @@
+#include "kernelkeys/KernelKeyContexts.hh"
+#include "kernelkeys/KernelKeys.h"
+#include "cryptography/Factories.hh"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <openssl/crypto.h>
+
+class KeyLookupCache
+{
+    std::mutex mutex;
+    std::unordered_map<std::string, int> serials;
+
+    static std::string getName(const char *description, int ringId)
+    {
+        return std::to_string(ringId) + ":" + description;
+    }
+
+public:
+    int lookup(const char *description, int ringId)
+    {
+        std::string name = getName(description, ringId);
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            auto it = this->serials.find(name);
+
+            if (it != this->serials.end())
+            {
+                return it->second;
+            }
+        }
+
+        // the search runs unlocked; concurrent misses for one description find the same serial;
+        int keyId = SearchKey(description, description, ringId);
+
+        if (keyId >= 0)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->serials[name] = keyId;
+        }
+
+        return keyId;
+    }
+
+    void forget(int keyId)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        for (auto it = this->serials.begin(); it != this->serials.end();)
+        {
+            it = it->second == keyId ? this->serials.erase(it) : ++it;
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->serials.clear();
+    }
+
+    static KeyLookupCache *getInstance()
+    {
+        static KeyLookupCache cache;
+
+        return &cache;
+    }
+};
+
+template <typename Create>
+static CryptoContext *CreateFromKernelKey(int keyId, Create create)
+{
+    unsigned char keyData[MAX_KERNEL_KEY_SIZE];
+    int keylen = ReadKeyInto(keyId, keyData, MAX_KERNEL_KEY_SIZE);
+
+    if (keylen < 0)
+    {
+        KeyLookupCache::getInstance()->forget(keyId);
+        return nullptr;
+    }
+
+    CryptoContext *ctx = create(keyData, keylen);
+    OPENSSL_cleanse(keyData, keylen);
+
+    return ctx;
+}
+
+extern "C"
+{
+    int LookupKey(const char *description, int ringId)
+    {
+        return description ? KeyLookupCache::getInstance()->lookup(description, ringId) : -1;
+    }
+
+    void ClearKeyLookupCache()
+    {
+        KeyLookupCache::getInstance()->clear();
+    }
+
+    int UnlockKeyToKeyring(const unsigned char *key, unsigned int keylen, KeyFormat format, const char *passphrase, const char *description, int ringId)
+    {
+        int keyId = LookupKey(description, ringId);
+
+        if (keyId >= 0 or not description)
+        {
+            return keyId;
+        }
+
+        AsymmetricKey *privateKey = AsymmetricKey::Factory::createPrivateKey();
+        unsigned int derLen = 0;
+        unsigned char *der = privateKey->setKeyData(key, keylen, format, passphrase) ? privateKey->exportKey(DerKeyFormat, derLen) : nullptr;
+
+        delete privateKey;
+
+        if (not der)
+        {
+            return -1;
+        }
+
+        keyId = CreateKey(description, (const char *)der, derLen, description, ringId);
+
+        OPENSSL_cleanse(der, derLen);
+        delete[] der;
+
+        return keyId;
+    }
+
+    CryptoContext *CreateAsymmetricEncryptionContextFromKernelKey(int keyId, KeyFormat format)
+    {
+        return CreateFromKernelKey(keyId, [format](const unsigned char *key, unsigned int keylen)
+                                   { return CreateAsymmetricEncryptionContextFromKeyData(key, keylen, format); });
+    }
+
+    CryptoContext *CreateAsymmetricDecryptionContextFromKernelKey(int keyId, KeyFormat format, const char *passphrase)
+    {
+        return CreateFromKernelKey(keyId, [format, passphrase](const unsigned char *key, unsigned int keylen)
+                                   { return CreateAsymmetricDecryptionContextFromKeyData(key, keylen, format, passphrase); });
+    }
+
+    CryptoContext *CreateSignatureContextFromKernelKey(int keyId, KeyFormat format, const char *passphrase)
+    {
+        return CreateFromKernelKey(keyId, [format, passphrase](const unsigned char *key, unsigned int keylen)
+                                   { return CreateSignatureContextFromKeyData(key, keylen, format, passphrase); });
+    }
+
+    CryptoContext *CreateVerificationContextFromKernelKey(int keyId, KeyFormat format)
+    {
+        return CreateFromKernelKey(keyId, [format](const unsigned char *key, unsigned int keylen)
+                                   { return CreateVerificationContextFromKeyData(key, keylen, format); });
+    }
+
+    CryptoContext *CreateEd25519SignatureContextFromKernelKey(int keyId, KeyFormat format, const char *passphrase)
+    {
+        return CreateFromKernelKey(keyId, [format, passphrase](const unsigned char *key, unsigned int keylen)
+                                   { return CreateEd25519SignatureContextFromKeyData(key, keylen, format, passphrase); });
+    }
+
+    CryptoContext *CreateEd25519VerificationContextFromKernelKey(int keyId, KeyFormat format)
+    {
+        return CreateFromKernelKey(keyId, [format](const unsigned char *key, unsigned int keylen)
+                                   { return CreateEd25519VerificationContextFromKeyData(key, keylen, format); });
+    }
+}
@@ -34,30 +34,42 @@ int CreateKey(const char *keyName, const char *keyMaterial, unsigned int keyMate
 
 int ReadKey(int keyId, char *data)
 {
-    if(keyId < 0 || data == NULL)
+    if(data == NULL)
     {
         return -1;
     }
 
-    char *buffer = malloc((MAX_KERNEL_KEY_SIZE + 1) * sizeof(char));
-    ssize_t bytesRead = keyctl_read(keyId, buffer, MAX_KERNEL_KEY_SIZE);
+    int bytesRead = ReadKeyInto(keyId, (unsigned char *)data, MAX_KERNEL_KEY_SIZE);
 
     if (bytesRead < 0)
     {
-        memset(buffer, 0, MAX_KERNEL_KEY_SIZE + 1);
-        free(buffer);
         return -1;
     }
 
-    memcpy(data, buffer, bytesRead);
     data[bytesRead] = 0;
 
-    memset(buffer, 0, MAX_KERNEL_KEY_SIZE + 1);
-    free(buffer);
-
     return bytesRead;
 }
 
+int ReadKeyInto(int keyId, unsigned char *data, unsigned int size)
+{
+    if(keyId < 0 || data == NULL)
+    {
+        return -1;
+    }
+
+    // keyctl_read reports the full payload size even when the buffer is too small for it;
+    long bytesRead = keyctl_read(keyId, (char *)data, size);
+
+    if (bytesRead < 0 || (unsigned long)bytesRead > size)
+    {
+        memset(data, 0, size);
+        return -1;
+    }
+
+    return (int)bytesRead;
+}
+
 int RemoveKey(int keyId)
 {
     if(keyId < 0)